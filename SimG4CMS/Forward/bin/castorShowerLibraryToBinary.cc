@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: castorShowerLibraryToBinary.cc
+// Description: Converts a CASTOR shower library from ROOT to the binary
+//              format of CastorShowerLibraryFile, which CastorShowerLibrary
+//              maps into memory when given as CastorShowerLibrary.FileName
+//
+// Usage: castorShowerLibraryToBinary <input.root> <output.bin>
+//                                    [BranchEvt [BranchEM [BranchHAD]]]
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/CastorShowerLibraryFile.h"
+#include "SimDataFormats/CaloHit/interface/CastorShowerLibraryInfo.h"
+#include "SimDataFormats/CaloHit/interface/CastorShowerEvent.h"
+#include "FWCore/FWLite/interface/FWLiteEnabler.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranchObject.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input.root> <output.bin>"
+              << " [BranchEvt [BranchEM [BranchHAD]]]\n"
+              << "  default branches: CastorShowerLibInfo emParticles hadParticles"
+              << std::endl;
+    return 1;
+  }
+  std::string inName    = argv[1];
+  std::string outName   = argv[2];
+  std::string branchEvt = (argc > 3) ? argv[3] : "CastorShowerLibInfo";
+  std::string branchEM  = (argc > 4) ? argv[4] : "emParticles";
+  std::string branchHAD = (argc > 5) ? argv[5] : "hadParticles";
+
+  FWLiteEnabler::enable();
+
+  TFile* hf = TFile::Open(inName.c_str());
+  if (hf == 0 || !hf->IsOpen()) {
+    std::cerr << "castorShowerLibraryToBinary: cannot open " << inName << std::endl;
+    return 2;
+  }
+  TTree* event = (TTree*) hf->Get("CastorCherenkovPhotons");
+  TBranchObject* evtInfo = event ? (TBranchObject*) event->GetBranch(branchEvt.c_str()) : 0;
+  TBranchObject* branch[CastorShowerLibraryFile::NType] = {0, 0};
+  if (event) {
+    branch[CastorShowerLibraryFile::EM]  = (TBranchObject*) event->GetBranch(branchEM.c_str());
+    branch[CastorShowerLibraryFile::HAD] = (TBranchObject*) event->GetBranch(branchHAD.c_str());
+  }
+  if (evtInfo == 0 || branch[0] == 0 || branch[1] == 0) {
+    std::cerr << "castorShowerLibraryToBinary: " << inName << " has no CastorCherenkovPhotons"
+              << " tree with branches " << branchEvt << ", " << branchEM << " and "
+              << branchHAD << std::endl;
+    return 2;
+  }
+
+  // Binning, with energies in GeV as in the ROOT file
+  CastorShowerLibraryInfo* info = new CastorShowerLibraryInfo();
+  evtInfo->SetAddress(&info);
+  evtInfo->GetEntry(0);
+  CastorShowerLibraryFile::Binning bin;
+  bin.totEvents     = info->Energy.getNEvts();
+  bin.nBinsE        = info->Energy.getNBins();
+  bin.nEvtPerBinE   = info->Energy.getNEvtPerBin();
+  bin.energies      = info->Energy.getBin();
+  bin.nBinsEta      = info->Eta.getNBins();
+  bin.nEvtPerBinEta = info->Eta.getNEvtPerBin();
+  bin.etas          = info->Eta.getBin();
+  bin.nBinsPhi      = info->Phi.getNBins();
+  bin.nEvtPerBinPhi = info->Phi.getNEvtPerBin();
+  bin.phis          = info->Phi.getBin();
+
+  // All records of both types
+  CastorShowerEvent* showerEvent = new CastorShowerEvent();
+  CastorShowerLibraryFile::Buffer buffer[CastorShowerLibraryFile::NType];
+  for (int k = 0; k < CastorShowerLibraryFile::NType; ++k) {
+    branch[k]->SetAddress(&showerEvent);
+    Long64_t nrc = branch[k]->GetEntries();
+    for (Long64_t irc = 0; irc < nrc; ++irc) {
+      if (branch[k]->GetEntry(irc) <= 0) {
+        std::cerr << "castorShowerLibraryToBinary: reading record " << irc << " of "
+                  << branch[k]->GetName() << " failed" << std::endl;
+        return 3;
+      }
+      buffer[k].append(*showerEvent);
+    }
+  }
+
+  if (!CastorShowerLibraryFile::write(outName, bin, buffer[0].records(), buffer[1].records())) {
+    std::cerr << "castorShowerLibraryToBinary: writing " << outName << " failed" << std::endl;
+    return 4;
+  }
+
+  // Read it back
+  CastorShowerLibraryFile check;
+  std::string error;
+  if (!check.map(outName, error)) {
+    std::cerr << "castorShowerLibraryToBinary: " << outName << " " << error << std::endl;
+    return 4;
+  }
+  std::cout << "castorShowerLibraryToBinary: " << outName << " written with "
+            << check.records(CastorShowerLibraryFile::EM).nRecords << " EM and "
+            << check.records(CastorShowerLibraryFile::HAD).nRecords << " HAD showers ("
+            << buffer[0].detID.size() + buffer[1].detID.size() << " hits, "
+            << check.size() << " bytes) from " << inName << std::endl;
+
+  hf->Close();
+  delete showerEvent;
+  delete info;
+  return 0;
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: zdcStepRecordToNtuple.cc
+// Description: Converts a step record file of ZdcTestAnalysis (written with
+//              StepNtupleFlag = 2) into the NTzdcstep ntuple written with
+//              StepNtupleFlag = 1; any other record file (e.g. of
+//              ForwardCaloSummary) with the ntuple name given
+//
+// Usage: zdcStepRecordToNtuple <input.bin> <output.root> [ntuple name]
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ZdcStepRecorder.h"
+
+#include "TFile.h"
+#include "TNtuple.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input.bin> <output.root> [ntuple name]" << std::endl;
+    return 1;
+  }
+  std::string inName  = argv[1];
+  std::string outName = argv[2];
+  std::string ntName  = (argc > 3) ? argv[3] : "NTzdcstep";
+
+  std::vector<std::string> columns;
+  std::vector<std::vector<float> > data;
+  std::string error;
+  if (!ZdcStepRecorder::read(inName, columns, data, error)) {
+    std::cerr << "zdcStepRecordToNtuple: " << inName << " " << error << std::endl;
+    return 2;
+  }
+
+  std::string varlist;
+  for (unsigned int k = 0; k < columns.size(); ++k)
+    varlist += (k == 0 ? "" : ":") + columns[k];
+
+  TFile out(outName.c_str(), "RECREATE");
+  if (!out.IsOpen()) {
+    std::cerr << "zdcStepRecordToNtuple: cannot create " << outName << std::endl;
+    return 3;
+  }
+  TNtuple* ntuple = new TNtuple(ntName.c_str(), ntName.c_str(), varlist.c_str());
+  size_t nRecords = columns.empty() ? 0 : data[0].size();
+  std::vector<float> record(columns.size());
+  for (size_t irc = 0; irc < nRecords; ++irc) {
+    for (unsigned int k = 0; k < columns.size(); ++k) record[k] = data[k][irc];
+    ntuple->Fill(&record[0]);
+  }
+  ntuple->Write();
+  out.Close();
+
+  std::cout << "zdcStepRecordToNtuple: " << nRecords << " records from " << inName
+            << " written to " << outName << std::endl;
+  return 0;
+}
@@ -20,6 +20,7 @@
  
 #include <string>
 
+class G4LogicalVolume;
 class TrackInformation;
 class SimTrackManager;
 class TrackingSlaveSD;
@@ -57,6 +58,7 @@ private:
   void           update(const BeginOfJob *);
   virtual void   clearHits();
   TrackInformation* getOrCreateTrackInformation(const G4Track *);
+  void           checkNames(const G4VTouchable *);
 
 private:
 
@@ -72,7 +74,10 @@ private:
   Local3DPoint globalExitPoint;
   G4VPhysicalVolume * oldVolume;
   uint32_t lastId;
+  uint32_t currentId;
   unsigned int lastTrack;
+  // logical volumes of the sensor and detector levels with checked names
+  const G4LogicalVolume * checkedLV[2];
   int eventno;
   std::string pname;
 
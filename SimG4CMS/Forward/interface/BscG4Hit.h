@@ -5,11 +5,16 @@
 // Package:     Bsc
 // Class  :     BscG4Hit
 // 
+// Positions, energies and the time slice are kept in single precision.
+// The local entry/exit points and the parent ID and vertex of the track
+// are only kept (in a separately allocated record) when the sensitive
+// detector is asked to store them; otherwise they read as 0.
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef BscG4Hit_h
 #define BscG4Hit_h
 
 #include "G4VHit.hh"
+#include "G4Allocator.hh"
 #include <CLHEP/Vector/ThreeVector.h>
 #include <boost/cstdint.hpp>
 #include <iostream>
@@ -26,6 +31,9 @@ public:
   BscG4Hit(const BscG4Hit &right);
   const BscG4Hit& operator=(const BscG4Hit &right);
   int operator==(const BscG4Hit &){return 0;}
+  // hits are taken from a per thread pool, freed with the hit collection
+  inline void *operator new(size_t);
+  inline void  operator delete(void *aHit);
   
   void         Draw(){}
   void         Print();
@@ -100,23 +108,32 @@ public:
     void setVz(float p);
 
 
+    bool hasDetails() const { return theDetails != 0; }
+
 private:
-  
-    G4ThreeVector entry;             //Entry point
-    G4ThreeVector entrylp;    //Entry  local point
-    G4ThreeVector exitlp;    //Exit  local point
-  double       elem;              //EnergyDeposit of EM particles
-  double       hadr;              //EnergyDeposit of HD particles
-  double       theIncidentEnergy; //Energy of the primary particle
-  G4int          theTrackID;        //Identification number of the primary
+
+  // optional local entry/exit points and parent ID and vertex of the track
+  struct Details {
+    Details() : parentId(0), vx(0), vy(0), vz(0) {
+      for (int k=0; k<3; ++k) entrylp[k] = exitlp[k] = 0;
+    }
+    float entrylp[3];             //Entry local point
+    float exitlp[3];              //Exit local point
+    int   parentId;
+    float vx, vy, vz;
+  };
+  Details * details();
+
+  float        entry[3];          //Entry point (x, y, z also give it)
+  float        elem;              //EnergyDeposit of EM particles
+  float        hadr;              //EnergyDeposit of HD particles
+  float        theIncidentEnergy; //Energy of the primary particle
+  G4int        theTrackID;        //Identification number of the primary
                                   //particle
-  double       theTimeSlice;      //Time Slice Identification
+  float        theTimeSlice;      //Time Slice Identification
 
   int theUnitID;         //Bsc Unit Number
 
-  float theX;
-  float theY;
-  float theZ;
   float thePabs  ;
     float theTof ;
     float theEnergyLoss   ;
@@ -126,15 +143,21 @@ private:
   float theThetaAtEntry ;
     float thePhiAtEntry    ;
 
-    int theParentId;
-    float theVx;
-    float theVy;
-    float theVz;
-
-
+  Details * theDetails;
 };
 
 std::ostream& operator<<(std::ostream&, const BscG4Hit&);
 
+extern G4ThreadLocal G4Allocator<BscG4Hit>* fpBscG4HitAllocator;
+
+inline void* BscG4Hit::operator new(size_t) {
+  if (!fpBscG4HitAllocator) fpBscG4HitAllocator = new G4Allocator<BscG4Hit>;
+  return (void*)fpBscG4HitAllocator->MallocSingle();
+}
+
+inline void BscG4Hit::operator delete(void *aHit) {
+  fpBscG4HitAllocator->FreeSingle((BscG4Hit*) aHit);
+}
+
 #endif
 
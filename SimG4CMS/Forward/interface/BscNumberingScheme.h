@@ -7,6 +7,8 @@
 #ifndef BscNumberingScheme_h
 #define BscNumberingScheme_h
 
+#include "SimG4CMS/Forward/interface/ForwardTouchableDecoder.h"
+
 #include "G4Step.hh"
 #include <boost/cstdint.hpp>
 #include "G4ThreeVector.hh"
@@ -34,7 +36,10 @@ class BscNumberingScheme {
   
   static void unpackBscIndex(const unsigned int& idx);
   
-  
+ private:
+
+  enum { kBSC1=0, kBSC2, kBSCTrap, kBSCTubs, kBSCTTop, kBSC2Pad };
+  mutable ForwardTouchableDecoder decoder;
   
 };
 
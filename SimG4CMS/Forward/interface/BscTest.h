@@ -63,15 +63,30 @@
 #include <TNamed.h>
 
 
+// Histograms are booked once and filled through their handles (H1Handle,
+// H2Handle), which index arrays directly; the name and number lookups are
+// kept for other users. When several managers exist (one per watcher, e.g.
+// one per thread) their histograms are summed by WriteToFile, and the last
+// manager writes the sums.
 class BscAnalysisHistManager : public TNamed {
         public:
 
+                enum H1Handle { kTrackPhi, kTrackTheta, kSumEDep, kTrackL,
+                                kVtxX, kVtxY, kVtxZ, kPrimaryEta, kPrimaryPhigrad,
+                                kPrimaryTh, kPrimaryLastpoZ, kPrimaryLastpoX,
+                                kPrimaryLastpoY, kXLastpoNumofpart,
+                                kYLastpoNumofpart, kzHits, kzHitsTrLoLe,
+                                kzHitsnoMI, nH1Handles };
+                enum H2Handle { kTrackP, kTrackM, kDetIDs, nH2Handles };
+
                 BscAnalysisHistManager(const TString& managername);
                 ~BscAnalysisHistManager();
 
+                TH1F* GetHisto(H1Handle handle) const { return fHisto1[handle]; }
                 TH1F* GetHisto(Int_t Number);
                 TH1F* GetHisto(const TObjString& histname);
 
+                TH2F* GetHisto2(H2Handle handle) const { return fHisto2[handle]; }
                 TH2F* GetHisto2(Int_t Number);
                 TH2F* GetHisto2(const TObjString& histname);
 
@@ -81,12 +96,15 @@ class BscAnalysisHistManager : public TNamed {
 
                 void BookHistos();
                 void StoreWeights();
-                void HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup);
-                void HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup, Int_t nbinsy, Axis_t ylow, Axis_t yup);
+                TH1F* HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup);
+                TH2F* HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup, Int_t nbinsy, Axis_t ylow, Axis_t yup);
 
                 const char* fTypeTitle;
                 TObjArray* fHistArray;
                 TObjArray* fHistNamesArray;
+                TH1F* fHisto1[nH1Handles];
+                TH2F* fHisto2[nH2Handles];
+                bool fWritten;
 
 };
 
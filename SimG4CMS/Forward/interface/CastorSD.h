@@ -24,7 +24,8 @@
 #include "SimG4CMS/Calo/interface/CaloSD.h"
 #include "SimG4CMS/Forward/interface/CastorShowerLibrary.h"
 #include "SimG4CMS/Forward/interface/CastorNumberingScheme.h"
-#include "SimDataFormats/CaloHit/interface/CastorShowerEvent.h"
+#include "SimG4CMS/Forward/interface/QuartzFiberResponse.h"
+#include "SimG4CMS/Forward/interface/LibraryHitAccumulator.h"
 #include "G4LogicalVolume.hh"
 
 class CastorSD : public CaloSD {
@@ -40,13 +41,24 @@ public:
 
 private:
 
+  // What a step does, from its logical volume
+  enum StepType { Inert, LibraryEntry, Quartz };
+
+  StepType                stepType(const G4LogicalVolume*) const;
+  bool                    libraryAccepts(G4Step*) const;
+  // keeps the particle of the first CASTOR step of the track; true if HAD
+  bool                    recordCastorHit(G4Track*) const;
+  double                  quartzPhotons(G4Step*, bool isHad) const;
   void                    getFromLibrary(G4Step*);
+  void                    storeLibraryHit(uint32_t, double, int);
   int                     setTrackID(G4Step*);
-  uint32_t                rotateUnitID(uint32_t, G4Track*, const CastorShowerEvent&);
+  uint32_t                rotateUnitID(uint32_t, G4Track*, const CastorShowerLibrary::Shower&);
   CastorNumberingScheme * numberingScheme;
   CastorShowerLibrary *   showerLibrary;
   G4LogicalVolume         *lvC3EF, *lvC3HF, *lvC4EF, *lvC4HF;
   G4LogicalVolume         *lvCAST;               // Pointer for CAST sensitive volume  (SL trigger)
+  CastorFiberResponse     fiberResponse;         // quartz plates at 45 deg
+  LibraryHitAccumulator   libraryHits;           // per cell sums of a library shower
   
   bool                    useShowerLibrary;
   double                  energyThresholdSL; 
@@ -13,6 +13,8 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "SimDataFormats/CaloHit/interface/CastorShowerLibraryInfo.h"
 #include "SimDataFormats/CaloHit/interface/CastorShowerEvent.h"
+#include "SimG4CMS/Forward/interface/CastorShowerLibraryFile.h"
+#include "DataFormats/HcalDetId/interface/HcalCastorDetId.h"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 
 #include "G4ParticleTable.hh"
@@ -26,6 +28,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 class G4Step;
 
@@ -39,17 +42,45 @@ public:
 
 public:
 
+  // CASTOR cells (HcalCastorDetId::denseIndex) of both ends; noCell for
+  // a hit whose detID is not a valid CASTOR cell
+  enum { nCells = 2*HcalCastorDetId::kNumberCellsPerEnd, noCell = 0xFFFF };
+
+  // A library shower: a view into hit arrays owned by the library, valid
+  // until the next call to getShowerHits
+  struct Shower {
+    Shower() : nHit(0), primE(0), primPhi(0), detID(0), cell(0), nPhotons(0), time(0) {}
+    unsigned int      getNhit() const          { return nHit; }
+    uint32_t          getDetID(int i) const    { return detID[i]; }
+    unsigned int      getCell(int i) const     { return cell[i]; }
+    float             getNphotons(int i) const { return nPhotons[i]; }
+    float             getTime(int i) const     { return time[i]; }
+    float             getPrimE() const         { return primE; }
+    float             getPrimPhi() const       { return primPhi; }
+    unsigned int      nHit;
+    float             primE, primPhi;          // GeV, rad
+    const uint32_t   *detID;
+    const uint16_t   *cell;
+    const float      *nPhotons, *time;
+  };
+
   void                initParticleTable(G4ParticleTable *);
-  CastorShowerEvent   getShowerHits(G4Step*, bool&);
-  int                 FindEnergyBin(double);
-  int                 FindEtaBin(double);
-  int                 FindPhiBin(double);
+  const Shower &      getShowerHits(G4Step*, bool&);
+  // Cell map moving a shower by whole octants (phi symmetry of CASTOR),
+  // from the octant of its primary to the one of a track at trackPhi:
+  // the cell of a hit is then rotation[shower.getCell(i)]
+  const uint16_t *    rotation(double trackPhi, double trackZ, const Shower &) const;
+  uint32_t            cellDetID(unsigned int cell) const { return cellID[cell]; }
+  int                 FindEnergyBin(double) const;
+  int                 FindEtaBin(double) const;
+  int                 FindPhiBin(double) const;
 
 protected:
 
   void                initFile(edm::ParameterSet const & );
   void                getRecord(int, int);
   void                loadEventInfo(TBranchObject *);
+  void                setBinning(const CastorShowerLibraryFile::Binning &);
 // if eta or phi is not given, take into account only the binning in energy
   void                select(int, double,double =0,double=9);  // Replaces interpolate / extrapolate
   // void                interpolate(int, double);
@@ -57,6 +88,27 @@ protected:
 
 private:
 
+  // Bin of a value for a list of lower bin edges in increasing order: the
+  // last bin extends to infinity, -1 below the first edge. A uniform grid
+  // finer than the narrowest bin maps the value to its bin in one step.
+  class BinFinder {
+  public:
+    BinFinder() : x0(0), invWidth(0) {}
+    void                init(const std::vector<double> & edges);
+    int                 find(double x) const;
+  private:
+    static const int    maxCells = 16384;
+    std::vector<double> edges;
+    std::vector<int>    cellBin;             // bin at the lower end of each cell
+    double              x0, invWidth;
+  };
+
+  bool                mapFile(const std::string &);
+  void                preloadLibrary(TBranchObject *, CastorShowerLibraryFile::Buffer &);
+  void                initCells();
+  static void         fillCells(const CastorShowerLibraryFile::Records &, std::vector<uint16_t> &);
+  static int          octant(double phi);
+
   TFile               *hf;                      
   TBranchObject       *evtInfo;                 // pointer to CastorShowerLibraryInfo-type branch 
   TBranchObject       *emBranch, *hadBranch;    // pointer to CastorShowerEvent-type branch
@@ -65,7 +117,15 @@ private:
   CastorShowerLibraryInfo  *eventInfo;
   CastorShowerEvent        *showerEvent;
 
-  bool                verbose;
+  bool                verbose, preload, interpolate;
+  CastorShowerLibraryFile          mapped;      // binary library (if used)
+  CastorShowerLibraryFile::Buffer  library[2];  // em, had (if preloaded)
+  CastorShowerLibraryFile::Buffer  current;     // last record read from file
+  CastorShowerLibraryFile::Records records[2];  // em, had in memory
+  std::vector<uint16_t> cells[2], currentCells; // cell of each hit of records/current
+  Shower              shower;
+  uint32_t            cellID[nCells];
+  uint16_t            rotated[2][8][nCells];    // [z<=0, z>0][octant shift][cell]
   unsigned int        nMomBin, totEvents, evtPerBin;
   
   std::vector<double> pmom;
@@ -80,5 +140,6 @@ private:
   std::vector<double> SLenergies;
   std::vector<double> SLetas;
   std::vector<double> SLphis;
+  BinFinder           energyBins, etaBins, phiBins;
 };
 #endif
@@ -0,0 +1,112 @@
+#ifndef SimG4CMS_CastorShowerLibraryFile_h
+#define SimG4CMS_CastorShowerLibraryFile_h
+///////////////////////////////////////////////////////////////////////////////
+// File: CastorShowerLibraryFile.h
+// Description: Binary format of the CASTOR shower library. The binning of
+//              CastorShowerLibraryInfo and the hits of all EM and HAD
+//              records are stored as flat arrays, so that the file can be
+//              mapped read-only into memory and used in place: processes
+//              on the same node share one copy through the page cache.
+//              Files are written from the ROOT libraries by the
+//              castorShowerLibraryToBinary tool.
+//
+//              Layout (native byte order, version 1):
+//                Header
+//                double energies[nEnergies] (GeV), etas[nEtas], phis[nPhis]
+//                for EM, then HAD records:
+//                  uint32 offset[nRecords+1]  first hit of each record
+//                  float  primE[nRecords] (GeV), primPhi[nRecords]
+//                  uint32 detID[nHits]
+//                  float  nPhotons[nHits], time[nHits]
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class CastorShowerEvent;
+
+class CastorShowerLibraryFile {
+
+public:
+
+  enum Type { EM = 0, HAD = 1, NType = 2 };
+
+  // Bins of the library, as in CastorShowerLibraryInfo
+  struct Binning {
+    Binning() : totEvents(0), nBinsE(0), nEvtPerBinE(0), nBinsEta(0),
+                nEvtPerBinEta(0), nBinsPhi(0), nEvtPerBinPhi(0) {}
+    unsigned int        totEvents;
+    unsigned int        nBinsE, nEvtPerBinE, nBinsEta, nEvtPerBinEta;
+    unsigned int        nBinsPhi, nEvtPerBinPhi;
+    std::vector<double> energies, etas, phis;   // GeV, -, rad
+  };
+
+  // Records of one type: the hits one record after the other
+  struct Records {
+    Records() : nRecords(0), offset(0), primE(0), primPhi(0), detID(0),
+                nPhotons(0), time(0) {}
+    unsigned int        nRecords;
+    const uint32_t     *offset;
+    const float        *primE, *primPhi;
+    const uint32_t     *detID;
+    const float        *nPhotons, *time;
+  };
+
+  // Records with their own storage, filled record by record
+  struct Buffer {
+    Buffer() : offset(1, 0) {}
+    void                  clear();
+    void                  append(CastorShowerEvent &);
+    Records               records() const;
+    size_t                bytes() const;
+    std::vector<uint32_t> offset;
+    std::vector<float>    primE, primPhi;
+    std::vector<uint32_t> detID;
+    std::vector<float>    nPhotons, time;
+  };
+
+  CastorShowerLibraryFile();
+  ~CastorShowerLibraryFile();
+
+  // true if the file starts as a binary library
+  static bool           isBinary(const std::string & fileName);
+  // maps the file read-only; false (with the reason in error) if it fails
+  bool                  map(const std::string & fileName, std::string & error);
+  bool                  isMapped() const { return (mapAddr != 0); }
+  const Binning &       binning() const { return bin; }
+  const Records &       records(int type) const { return rec[(type == EM) ? EM : HAD]; }
+  size_t                size() const { return mapSize; }
+
+  static bool           write(const std::string & fileName, const Binning &,
+                              const Records & em, const Records & had);
+
+private:
+
+  CastorShowerLibraryFile(const CastorShowerLibraryFile &);
+  CastorShowerLibraryFile & operator=(const CastorShowerLibraryFile &);
+
+  void                  unmap();
+
+  struct Header {
+    char                magic[8];
+    uint32_t            version;
+    uint32_t            totEvents;
+    uint32_t            nBinsE, nEvtPerBinE, nBinsEta, nEvtPerBinEta;
+    uint32_t            nBinsPhi, nEvtPerBinPhi;
+    uint32_t            nEnergies, nEtas, nPhis;
+    uint32_t            nRecords[NType], nHits[NType];
+    uint32_t            pad;                     // 8-byte size
+  };
+  static size_t         recordBytes(uint32_t nRecords, uint32_t nHits);
+
+  static const char     fileMagic[8];
+  static const uint32_t fileVersion = 1;
+
+  void                 *mapAddr;
+  size_t                mapSize;
+  Binning               bin;
+  Records               rec[NType];
+};
+#endif
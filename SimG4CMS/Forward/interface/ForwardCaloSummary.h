@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardCaloSummary.h
+// Description: Compact per channel summary of the ZDC and CASTOR hits of
+//              each event, meant to replace the event ntuples of
+//              ZdcTestAnalysis, CastorTestAnalysis and DoCastorAnalysis.
+//              The hits are summed per channel into tables sized once;
+//              for every channel with a signal one record is written to
+//              a ZdcStepRecorder file (compressed in the background):
+//                evt, det (1 ZDC, 2 CASTOR), index (zdcIndex or
+//                castorIndex),
+//                npeem, npehad (signal, i.e. photoelectrons, of the EM and
+//                hadronic parts), tmean, trms (signal weighted time slice
+//                moments, ns), nhits
+//              The file is converted into an ntuple by the
+//              zdcStepRecordToNtuple tool.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef ForwardCaloSummary_h
+#define ForwardCaloSummary_h
+
+#include "SimG4Core/Notification/interface/BeginOfRun.h"
+#include "SimG4Core/Notification/interface/EndOfEvent.h"
+#include "SimG4Core/Notification/interface/Observer.h"
+#include "SimG4Core/Watcher/interface/SimWatcher.h"
+#include "SimG4CMS/Calo/interface/CaloG4HitCollection.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/HcalDetId/interface/HcalZDCDetId.h"
+#include "DataFormats/HcalDetId/interface/HcalCastorDetId.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class ZdcStepRecorder;
+
+class ForwardCaloSummary : public SimWatcher,
+                           public Observer<const BeginOfRun *>,
+                           public Observer<const EndOfEvent *> {
+
+public:
+  ForwardCaloSummary(const edm::ParameterSet &p);
+  virtual ~ForwardCaloSummary();
+
+  enum Detector { ZDC=1, CASTOR=2 };
+
+  // channel index of a ZDC unit ID: side (0 for z<0) * nZdcSide + EM 1-5,
+  // HAD 1-4 or RPD pad 1-16 in this order; -1 if it is not a channel.
+  // HcalZDCDetId keeps 4 channel bits, so RPD pad 16 reads back as 0.
+  static int zdcIndex(uint32_t unitID);
+  // HcalCastorDetId denseIndex of a CASTOR unit ID, -1 if not valid
+  static int castorIndex(uint32_t unitID);
+
+  static const uint32_t nZdcEM     = 5;
+  static const uint32_t nZdcHad    = 4;
+  static const uint32_t nZdcRPD    = 16;
+  static const uint32_t nZdcSide   = nZdcEM+nZdcHad+nZdcRPD;
+  static const uint32_t nZdc       = 2*nZdcSide;
+  static const uint32_t nCastor    = HcalCastorDetId::kSizeForDenseIndexing;
+
+private:
+  // observer classes
+  void update(const BeginOfRun * run);
+  void update(const EndOfEvent * evt);
+
+  struct Channel {
+    double   em, had, t, t2;
+    uint32_t nHits;
+  };
+
+  void add(Detector det, const CaloG4HitCollection * hc);
+  void write(int evt);
+
+  int                    verbosity;
+  std::string            fileName, zdcCollection, castorCollection;
+  int                    zdcID, castorID;
+  ZdcStepRecorder       *recorder;
+  unsigned long          nEvents;
+
+  // ZDC channels first, then the CASTOR ones; fired lists the channels
+  // with hits in the current event
+  Channel                channels[nZdc+nCastor];
+  std::vector<uint32_t>  fired;
+};
+
+#endif // ForwardCaloSummary_h
@@ -0,0 +1,93 @@
+#ifndef SimG4CMS_ForwardHitIndex_h
+#define SimG4CMS_ForwardHitIndex_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardHitIndex.h
+// Description: Index of the hits of one event by (track ID, time slice ID,
+//              unit ID), for the tracker-like forward SDs (TotemSD, BscSD,
+//              BHMSD, FastTimerSD) which look for the hit a step adds to.
+//              Open addressing with linear probing in a power-of-two table
+//              kept at most half full; the hits are not owned.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <vector>
+
+template <class Hit>
+class ForwardHitIndex {
+
+public:
+
+  explicit ForwardHitIndex(unsigned int capacity=1024) : nUsed(0) {
+    unsigned int size = 16;
+    while (size < 2*capacity) size *= 2;
+    slots.resize(size);
+    mask = size-1;
+  }
+
+  // to be called when the hit collection of a new event is made
+  void clear() {
+    if (nUsed == 0) return;
+    for (unsigned int k = 0; k < slots.size(); ++k) slots[k].hit = 0;
+    nUsed = 0;
+  }
+
+  Hit * find(int trackID, int timeSliceID, uint32_t unitID) const {
+    for (unsigned int k = hash(trackID, timeSliceID, unitID) & mask; slots[k].hit != 0; k = (k+1) & mask) {
+      const Slot & s = slots[k];
+      if (s.unitID == unitID && s.trackID == trackID && s.timeSliceID == timeSliceID) return s.hit;
+    }
+    return 0;
+  }
+
+  // indexes the hit under the IDs the SD looks it up with (not the ones
+  // read back from the hit, whose time slice is rounded to float); a hit
+  // already indexed with the same IDs is kept, as the first one found by
+  // a scan of the collection
+  void insert(int trackID, int timeSliceID, uint32_t unitID, Hit * hit) {
+    if (2*(nUsed+1) > slots.size()) grow();
+    put(trackID, timeSliceID, unitID, hit);
+  }
+
+  unsigned int size() const { return nUsed; }
+
+private:
+
+  struct Slot {
+    Slot() : unitID(0), trackID(0), timeSliceID(0), hit(0) {}
+    uint32_t     unitID;
+    int          trackID, timeSliceID;
+    Hit         *hit;
+  };
+
+  static uint32_t hash(int trackID, int timeSliceID, uint32_t unitID) {
+    uint64_t h = (uint64_t(uint32_t(trackID)) << 32) ^ (uint64_t(uint32_t(timeSliceID)) << 20) ^ unitID;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return uint32_t(h >> 32);
+  }
+
+  void put(int trackID, int timeSliceID, uint32_t unitID, Hit * hit) {
+    unsigned int k = hash(trackID, timeSliceID, unitID) & mask;
+    for (; slots[k].hit != 0; k = (k+1) & mask) {
+      const Slot & s = slots[k];
+      if (s.unitID == unitID && s.trackID == trackID && s.timeSliceID == timeSliceID) return;
+    }
+    slots[k].unitID      = unitID;
+    slots[k].trackID     = trackID;
+    slots[k].timeSliceID = timeSliceID;
+    slots[k].hit         = hit;
+    ++nUsed;
+  }
+
+  void grow() {
+    std::vector<Slot> old(2*slots.size());
+    old.swap(slots);
+    mask  = slots.size()-1;
+    nUsed = 0;
+    for (unsigned int k = 0; k < old.size(); ++k)
+      if (old[k].hit != 0) put(old[k].trackID, old[k].timeSliceID, old[k].unitID, old[k].hit);
+  }
+
+  std::vector<Slot> slots;
+  unsigned int      mask, nUsed;
+};
+#endif
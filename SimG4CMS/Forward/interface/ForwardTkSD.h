@@ -0,0 +1,175 @@
+#ifndef SimG4CMS_ForwardTkSD_h
+#define SimG4CMS_ForwardTkSD_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardTkSD.h
+// Description: Common part of the tracker-like forward sensitive detectors
+//              (TotemSD, BscSD, BHMSD, FastTimerSD), which sum the steps of
+//              a track in a detector unit and time slice into one transient
+//              hit and turn the hits into PSimHits at the end of the event.
+//              The base owns the hit collection and the step bookkeeping
+//              (hit lookup, hit storage, per event reset); Derived fills
+//              the step information (GetStepInfo), the new hits
+//              (CreateNewHit, UpdateHit) and the per primary data
+//              (ResetForNewPrimary). Hits are expected to come from a
+//              G4Allocator pool (operator new of the hit class).
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4Core/Notification/interface/Observer.h"
+#include "SimG4Core/Notification/interface/BeginOfEvent.h"
+#include "SimG4Core/Notification/interface/EndOfEvent.h"
+#include "SimG4Core/SensitiveDetector/interface/SensitiveTkDetector.h"
+#include "SimDataFormats/SimHitMaker/interface/TrackingSlaveSD.h"
+#include "SimG4CMS/Forward/interface/ForwardHitIndex.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "G4SDManager.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4THitsCollection.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <string>
+#include <vector>
+
+class SimTrackManager;
+
+template <class Derived, class Hit>
+class ForwardTkSD : public SensitiveTkDetector,
+                    public Observer<const BeginOfEvent*>,
+                    public Observer<const EndOfEvent*> {
+
+public:
+
+  typedef G4THitsCollection<Hit> HitCollection;
+
+  // category: message logger category of the detector
+  ForwardTkSD(std::string name, const DDCompactView & cpv,
+              const SensitiveDetectorCatalog & clg, edm::ParameterSet const & p,
+              const SimTrackManager* manager, const std::string & category) :
+    SensitiveTkDetector(name, cpv, clg, p), slave(0), name(name),
+    category(category), hcID(-1), theHC(0), theManager(manager), tsID(-2),
+    primID(-2), storeHitDetails(true), currentHit(0), theTrack(0),
+    currentPV(0), unitID(0), previousUnitID(0), primaryID(0), tSliceID(0),
+    tSlice(0), preStepPoint(0), postStepPoint(0), edeposit(0), eventno(0) {
+
+    collectionName.insert(name);
+    slave = new TrackingSlaveSD(name);
+
+    // attach detectors (LogicalVolumes)
+    const std::vector<std::string>& lvNames = clg.logicalNames(name);
+    this->Register();
+    for (std::vector<std::string>::const_iterator it=lvNames.begin();
+         it !=lvNames.end(); it++) {
+      this->AssignSD(*it);
+      edm::LogInfo(category) << name << " : Assigns SD to LV " << (*it);
+    }
+  }
+
+  virtual ~ForwardTkSD() { delete slave; }
+
+  virtual void   Initialize(G4HCofThisEvent * HCE) {
+    theHC = new HitCollection(name, collectionName[0]);
+    if (hcID<0)
+      hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+    HCE->AddHitsCollection(hcID, theHC);
+    hitIndex.clear();
+
+    tsID   = -2;
+    primID = -2;
+  }
+
+  virtual void   clear() {}
+  virtual void   DrawAll() {}
+  virtual void   PrintAll() {
+    LogDebug(category) << name << ": Collection " << theHC->GetName();
+    theHC->PrintAllHits();
+  }
+
+  void           fillHits(edm::PSimHitContainer& c, std::string n) {
+    if (slave->name() == n) c=slave->hits();
+  }
+
+  std::vector<std::string> getNames() {
+    std::vector<std::string> temp;
+    temp.push_back(slave->name());
+    return temp;
+  }
+
+protected:
+
+  virtual void   update(const BeginOfEvent * i) {
+    LogDebug(category) << " Dispatched BeginOfEvent for " << GetName() << " !";
+    clearHits();
+    eventno = (*i)()->GetEventID();
+  }
+  virtual void   update(const ::EndOfEvent *) {}
+  virtual void   clearHits() { slave->Initialize(); }
+
+  // true if the step adds to an existing hit (which is then updated)
+  bool           HitExists() {
+    if (primaryID<1) {
+      edm::LogWarning(category) << "***** " << name << " error: primaryID = "
+                                << primaryID << " maybe detector name changed";
+    }
+
+    // Update if in the same detector, time-slice and for same track
+    if (tSliceID == tsID && unitID==previousUnitID) {
+      derived().UpdateHit();
+      return true;
+    }
+    // Reset entry point for new primary
+    if (primaryID != primID)
+      derived().ResetForNewPrimary();
+
+    // look for a hit with the same primID, unitID, tSliceID
+    Hit* aPreviousHit = hitIndex.find(primaryID, tSliceID, unitID);
+    if (aPreviousHit) {
+      currentHit = aPreviousHit;
+      derived().UpdateHit();
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  void           StoreHit(Hit* hit) {
+    if (primID<0) return;
+    if (hit == 0) {
+      edm::LogWarning(category) << name << ": hit to be stored is NULL !!";
+      return;
+    }
+    theHC->insert( hit );
+    // the hit is made from the current step: index it under its keys
+    hitIndex.insert(primaryID, tSliceID, unitID, hit);
+  }
+
+  TrackingSlaveSD*            slave;
+  std::string                 name, category;
+  G4int                       hcID;
+  HitCollection*              theHC;
+  ForwardHitIndex<Hit>        hitIndex;
+  const SimTrackManager*      theManager;
+
+  G4int                       tsID, primID;
+  // keep the optional details (track origin, local points) in new hits
+  bool                        storeHitDetails;
+  Hit*                        currentHit;
+  G4Track*                    theTrack;
+  G4VPhysicalVolume*          currentPV;
+  uint32_t                    unitID, previousUnitID;
+  G4int                       primaryID, tSliceID;
+  G4double                    tSlice;
+
+  G4StepPoint*                preStepPoint;
+  G4StepPoint*                postStepPoint;
+  float                       edeposit;
+  G4ThreeVector               hitPoint;
+
+  int                         eventno;
+
+private:
+
+  Derived &      derived() { return static_cast<Derived&>(*this); }
+};
+#endif
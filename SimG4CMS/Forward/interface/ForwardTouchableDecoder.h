@@ -0,0 +1,96 @@
+#ifndef SimG4CMS_ForwardTouchableDecoder_h
+#define SimG4CMS_ForwardTouchableDecoder_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardTouchableDecoder.h
+// Description: Decoding support for the forward numbering schemes (Bsc,
+//              Totem T1, T2 and RP). A scheme declares the logical volumes
+//              it looks for (by name, with a tag of its own) and the number
+//              of history levels its unit ID depends on, or an envelope
+//              volume the path ends at (Bsc, T1). The names are
+//              looked up in the G4LogicalVolumeStore once, at the first
+//              step of the run; afterwards the scheme decodes the path with
+//              the tags and copy numbers only.
+//              The unit ID of a path (physical volume and copy number of
+//              each level, from the leaf up) is kept in a small direct
+//              mapped cache, so a path is decoded once as long as it stays
+//              in the cache. Sensitive detectors (and so their numbering
+//              schemes) are built per thread, so the cache is not shared.
+//
+//              Usage, in the getUnitID method of a scheme:
+//                uint32_t id;
+//                if (decoder.find(touch, id)) return id;
+//                ... compute id from tag(level), copyNo(level) ...
+//                return decoder.store(id);
+///////////////////////////////////////////////////////////////////////////////
+
+#include "G4VTouchable.hh"
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+class ForwardTouchableDecoder {
+
+public:
+
+  // nLevels: number of levels (from the leaf) the unit ID depends on, 0 for
+  // all levels up to the first envelope (the whole history if there is no
+  // envelope); cacheSize is rounded up to a power of two
+  explicit ForwardTouchableDecoder(int nLevels=0, unsigned int cacheSize=64);
+
+  // declares the logical volume(s) of the given name; tag >= 0
+  void                  addVolume(const std::string & name, int tag);
+  // as addVolume, for a volume enclosing the detector: the path is read
+  // from the leaf up to the first envelope, levels above it are ignored
+  void                  addEnvelope(const std::string & name, int tag);
+  // looks the declared names up and empties the cache (done automatically
+  // before the first find)
+  void                  resolve();
+
+  // reads the path of the touchable; returns true with the cached unit ID
+  // if the path has been decoded before
+  bool                  find(const G4VTouchable * touch, uint32_t & id);
+  // caches the unit ID of the path read by the last find and returns it
+  uint32_t              store(uint32_t id);
+
+  // path read by the last find; level 0 is the leaf
+  int                   levels() const { return (int)(path.size()); }
+  int                   copyNo(int level) const { return path[level].copy; }
+  // tag of the logical volume at the level, -1 if it was not declared
+  int                   tag(int level) const;
+
+private:
+
+  struct Level {
+    const G4VPhysicalVolume * pv;
+    int                       copy;
+    bool operator==(const Level & l) const { return (pv == l.pv && copy == l.copy); }
+  };
+
+  struct Volume {
+    std::string           name;
+    int                   tag;
+    bool                  envelope;
+  };
+
+  struct Slot {
+    Slot() : used(false), id(0) {}
+    bool                  used;
+    uint32_t              id;
+    std::vector<Level>    path;
+  };
+
+  int                                                  nLevels;
+  bool                                                 resolved;
+  std::vector<Volume>                                  names;
+  std::vector<std::pair<const G4LogicalVolume*,int> >  volumes;
+  std::vector<const G4LogicalVolume*>                  envelopes;
+  std::vector<Level>                                   path;
+  std::vector<Slot>                                    cache;
+  unsigned int                                         mask, slot;
+};
+#endif
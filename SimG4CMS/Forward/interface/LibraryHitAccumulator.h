@@ -0,0 +1,42 @@
+#ifndef SimG4CMS_LibraryHitAccumulator_h
+#define SimG4CMS_LibraryHitAccumulator_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: LibraryHitAccumulator.h
+// Description: Sums the deposits of one library shower per cell (dense
+//              index of the detector unit) and time slice, so that a
+//              sensitive detector creates or updates one CaloG4Hit per
+//              (cell, time slice) instead of one per library hit. Used by
+//              ZdcSD and CastorSD. The time slice is int(time/unit) with
+//              times in ns, as for CaloHitID; the owner passes the
+//              TimeSliceUnit of its CaloSD so that both agree.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+class LibraryHitAccumulator {
+
+public:
+
+  // Sum for one (cell, time slice); time and tag are those of the first
+  // deposit added to it
+  struct Entry {
+    int                 cell, slice, tag;
+    double              time, em, had;
+  };
+
+  LibraryHitAccumulator(int nCells, double unit);
+
+  void                  add(int cell, double time, double em, double had, int tag=-1);
+  // sums in the order of their first deposit
+  const std::vector<Entry> & entries() const { return entry; }
+  void                  clear();
+  bool                  empty() const { return entry.empty(); }
+
+private:
+
+  double                invUnit;
+  std::vector<int>      head;      // [cell] last entry of the cell, -1 if none
+  std::vector<int>      next;      // [entry] previous entry of the same cell
+  std::vector<Entry>    entry;
+};
+#endif
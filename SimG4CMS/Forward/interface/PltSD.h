@@ -20,6 +20,7 @@
  
 #include <string>
 
+class G4LogicalVolume;
 class TrackInformation;
 class SimTrackManager;
 class TrackingSlaveSD;
@@ -57,6 +58,8 @@ private:
   void           update(const BeginOfJob *);
   virtual void   clearHits();
   TrackInformation* getOrCreateTrackInformation(const G4Track *);
+  void           checkNames(const G4VTouchable *);
+  static uint32_t telescopeId(int pltNum, int telNum);
 
 private:
 
@@ -72,7 +75,14 @@ private:
   Local3DPoint globalExitPoint;
   G4VPhysicalVolume * oldVolume;
   uint32_t lastId;
+  uint32_t currentId;
   unsigned int lastTrack;
+
+  // detId part of the telescopes by PLT side (0 for -z) and telescope copy number
+  static const int nTelescopes = 8;
+  uint32_t telescopeIds[2][nTelescopes];
+  // logical volumes of the sensor, telescope and PLT levels with checked names
+  const G4LogicalVolume * checkedLV[3];
   int eventno;
   std::string pname;
 
@@ -0,0 +1,146 @@
+#ifndef SimG4CMS_QuartzFiberResponse_h
+#define SimG4CMS_QuartzFiberResponse_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: QuartzFiberResponse.h
+// Description: Cherenkov response of quartz fibers/plates for one step,
+//              shared by ZdcSD and CastorSD. The detector constants are a
+//              template parameter; the fiber direction is set at
+//              construction. The fraction of the Cherenkov cone trapped by
+//              total internal reflection (d_qz) is tabulated in
+//              (theta, beta) and interpolated bilinearly.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "G4Poisson.hh"
+#include "CLHEP/Units/GlobalPhysicalConstants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Constants of the ZDC quartz fibers
+struct ZdcQuartzFiber {
+  static constexpr double bThreshold         = 0.67;
+  static constexpr double nMedium            = 1.4925;
+  static constexpr double photEnSpectrDE     = 1.24;   // eV (400-700 nm)
+  static constexpr double thFullRefl         = 23.;    // deg
+  static constexpr double effPMTandTransport = 0.15;
+  static constexpr double reflPower          = 0.;
+  static constexpr double lightScale         = 1.;
+};
+
+// Constants of the CASTOR quartz plates
+struct CastorQuartzFiber {
+  static constexpr double bThreshold         = 0.67;
+  static constexpr double nMedium            = 1.4925;
+  static constexpr double photEnSpectrDE     = 1.24;   // eV (400-700 nm)
+  static constexpr double thFullRefl         = 23.;    // deg
+  static constexpr double effPMTandTransport = 0.19;
+  static constexpr double reflPower          = 0.1;
+  static constexpr double lightScale         = 0.307;
+};
+
+template <class C>
+class QuartzFiberResponse {
+
+public:
+
+  // thFibDir: fiber direction (deg) w.r.t. the beam axis
+  explicit QuartzFiberResponse(double thFibDir) {
+    thFibDirRad   = thFibDir*pi/180.;
+    thFullReflRad = C::thFullRefl*pi/180.;
+    aFib          = tan(thFibDirRad)+tan(fabs(thFibDirRad-thFullReflRad));
+    invStepTh     = (nTh-1)/pi;
+    invStepBeta   = (nBeta-1)/(1.-C::bThreshold);
+    dqzTable.resize(nTh*nBeta);
+    for (int ith = 0; ith < nTh; ++ith)
+      for (int ib = 0; ib < nBeta; ++ib)
+        dqzTable[ith*nBeta+ib] = acceptanceExact(ith/invStepTh, C::bThreshold + ib/invStepBeta);
+  }
+
+  double betaThreshold() const { return C::bThreshold; }
+  double fiberDirection() const { return thFibDirRad; }
+
+  // fraction of the Cherenkov light trapped in the fiber for a particle at
+  // polar angle th (rad) w.r.t. the beam axis with velocity beta
+  double acceptance(double th, double beta) const {
+    double ut = th*invStepTh;
+    double ub = (beta-C::bThreshold)*invStepBeta;
+    if (ut < 0. || ut >= nTh-1 || ub < 0. || ub >= nBeta-1) return acceptanceExact(th, beta);
+    int          it = int(ut);
+    int          ib = int(ub);
+    double       ft = ut - it;
+    double       fb = ub - ib;
+    const float* t0 = &dqzTable[it*nBeta+ib];
+    const float* t1 = t0 + nBeta;
+    // d_qz jumps between 0 and 1 at the edges of the full reflection cone:
+    // do not interpolate across them
+    float lo = std::min(std::min(t0[0],t0[1]),std::min(t1[0],t1[1]));
+    float hi = std::max(std::max(t0[0],t0[1]),std::max(t1[0],t1[1]));
+    if (hi-lo > maxStep) return acceptanceExact(th, beta);
+    return (1.-ft)*((1.-fb)*t0[0] + fb*t0[1]) + ft*((1.-fb)*t1[0] + fb*t1[1]);
+  }
+
+  double acceptanceExact(double th, double beta) const {
+    // theta of cone with Cherenkov photons w.r.t.direction of charged part.
+    double costhcher = 1./(C::nMedium*beta);
+    double thcher    = acos(std::min(std::max(costhcher,-1.),1.));
+    // diff thetas of charged part. and quartz direction in LabRF
+    double delFibPart = fabs(th - thFibDirRad);
+
+    // if (d > (r+a))
+    if (delFibPart > (thFullReflRad + thcher)) return 0.;
+    // if ((DelFibPart + thcher) < thFullReflRad )  [(d+r) < a]
+    if ((th + thcher) < (thFibDirRad+thFullReflRad) &&
+        (th - thcher) > (thFibDirRad-thFullReflRad)) return 1.;
+    // if ((thcher - DelFibPart ) > thFullReflRad )  [(r-d) > a]
+    if ((thFibDirRad + thFullReflRad) < (th + thcher) &&
+        (thFibDirRad - thFullReflRad) > (th - thcher)) return 0.;
+    // use crossed length of circles(cone projection) - dC1/dC2
+    double d = fabs(tan(th)-tan(thFibDirRad));
+    double r = tan(th)+tan(fabs(th-thcher));
+    double arg_arcos = 0.;
+    double tan_arcos = 2.*aFib*d;
+    if (tan_arcos != 0.) arg_arcos = (r*r-aFib*aFib-d*d)/tan_arcos;
+    arg_arcos = fabs(arg_arcos);
+    double th_arcos = acos(std::min(arg_arcos,1.));
+    return fabs(th_arcos/pi/2.);
+  }
+
+  // mean number of Cherenkov photons for a step of length stepL (cm)
+  double meanPhotons(double charge, double beta, double stepL) const {
+    return 370.*charge*charge*(1. - 1./(C::nMedium*C::nMedium*beta*beta))*
+      C::photEnSpectrDE*stepL;
+  }
+
+  // photons seen for one step; scale multiplies the mean number produced
+  double photons(double charge, double beta, double th, double stepL,
+                 double scale=1.) const {
+    if (charge == 0. || beta <= C::bThreshold) return 0.;
+    double d_qz  = acceptance(th, beta);
+    double proba = d_qz + (1.-d_qz)*C::reflPower;
+    if (proba <= 0.) return 0.;
+    G4int poissNCherPhot = (G4int) G4Poisson(meanPhotons(charge, beta, stepL)*scale);
+    if (poissNCherPhot < 0) poissNCherPhot = 0;
+    return poissNCherPhot*C::effPMTandTransport*proba*C::lightScale;
+  }
+
+  // same for n steps at once
+  void photons(int n, const double* charge, const double* beta, const double* th,
+               const double* stepL, const double* scale, double* nphot) const {
+    for (int i = 0; i < n; ++i)
+      nphot[i] = photons(charge[i], beta[i], th[i], stepL[i], scale ? scale[i] : 1.);
+  }
+
+private:
+
+  static const int   nTh = 720, nBeta = 200;
+  static constexpr float maxStep = 0.05;
+  double             thFibDirRad, thFullReflRad, aFib;
+  double             invStepTh, invStepBeta;
+  std::vector<float> dqzTable;   // [ith][ibeta]
+};
+
+typedef QuartzFiberResponse<ZdcQuartzFiber>    ZdcFiberResponse;
+typedef QuartzFiberResponse<CastorQuartzFiber> CastorFiberResponse;
+
+#endif
@@ -20,6 +20,11 @@
               in the unit where the shower starts) 
    - the TrackID (= Identification number of the incident particle)
    - the IncidentEnergy (= energy of that particle)
+
+   Positions, energies and the time slice are kept in single precision.
+   The parent ID and vertex of the track are only kept (in a separately
+   allocated record) when the sensitive detector is asked to store them;
+   otherwise they read as 0.
  
 */
 //
@@ -32,6 +37,7 @@
 // user include files
 
 #include "G4VHit.hh"
+#include "G4Allocator.hh"
 #include "DataFormats/Math/interface/Point3D.h"
 #include <boost/cstdint.hpp>
 #include <iostream>
@@ -48,13 +54,16 @@ public:
   // ---------- operators ----------------------------------
   const TotemG4Hit& operator=(const TotemG4Hit &right);
   int operator==(const TotemG4Hit &){return 0;}
+  // hits are taken from a per thread pool, freed with the hit collection
+  inline void *operator new(size_t);
+  inline void  operator delete(void *aHit);
 
   // ---------- member functions ---------------------------
   void         Draw(){}
   void         Print();
 
   math::XYZPoint   getEntry() const;
-  void         setEntry(double x, double y, double z)      {entry.SetCoordinates(x,y,z);}
+  void         setEntry(double x, double y, double z)      {entry[0]=x; entry[1]=y; entry[2]=z;}
   
   double       getEM() const;
   void         setEM (double e);
@@ -112,22 +121,27 @@ public:
   void         setVx(float p);
   void         setVy(float p);
   void         setVz(float p);
+  bool         hasOrigin() const { return theOrigin != 0; }
 
 private:
-  
-  math::XYZPoint   entry;             //Entry point
-  double       elem;              //EnergyDeposit of EM particles
-  double       hadr;              //EnergyDeposit of HD particles
-  double       theIncidentEnergy; //Energy of the primary particle
+
+  // optional parent ID and vertex of the track
+  struct Origin {
+    Origin() : parentId(0), vx(0), vy(0), vz(0) {}
+    int        parentId;
+    float      vx, vy, vz;
+  };
+  Origin *     origin();
+
+  float        entry[3];          //Entry point (x, y, z also give it)
+  float        elem;              //EnergyDeposit of EM particles
+  float        hadr;              //EnergyDeposit of HD particles
+  float        theIncidentEnergy; //Energy of the primary particle
   int          theTrackID;        //Identification number of the primary
                                   //particle
   uint32_t     theUnitID;         //Totem Unit Number
-  double       theTimeSlice;      //Time Slice Identification
-
+  float        theTimeSlice;      //Time Slice Identification
 
-  float        theX;
-  float        theY;
-  float        theZ;
   float        thePabs;
   float        theTof;
   float        theEnergyLoss;
@@ -135,17 +149,22 @@ private:
 
   float        theThetaAtEntry;
   float        thePhiAtEntry;
-  math::XYZPoint   theEntryPoint;
-  math::XYZPoint   theExitPoint;
-
-  int          theParentId;
-  float        theVx;
-  float        theVy;
-  float        theVz;
 
+  Origin *     theOrigin;
 };
 
 std::ostream& operator<<(std::ostream&, const TotemG4Hit&);
 
+extern G4ThreadLocal G4Allocator<TotemG4Hit>* fpTotemG4HitAllocator;
+
+inline void* TotemG4Hit::operator new(size_t) {
+  if (!fpTotemG4HitAllocator) fpTotemG4HitAllocator = new G4Allocator<TotemG4Hit>;
+  return (void*)fpTotemG4HitAllocator->MallocSingle();
+}
+
+inline void TotemG4Hit::operator delete(void *aHit) {
+  fpTotemG4HitAllocator->FreeSingle((TotemG4Hit*) aHit);
+}
+
 #endif
 
@@ -24,6 +24,7 @@
 // user include files
 
 #include "SimG4CMS/Forward/interface/TotemVDetectorOrganization.h"
+#include "SimG4CMS/Forward/interface/ForwardTouchableDecoder.h"
 #include "globals.hh"
 
 class TotemRPOrganization : public TotemVDetectorOrganization {
@@ -49,6 +50,8 @@ private:
   int              _currentPlane;
   int              _currentCSC;
   int              _currentLayer;
+  // declares the myRP volumes; caches the unit IDs of the touchable paths
+  ForwardTouchableDecoder _decoder;
 
 };
 #endif
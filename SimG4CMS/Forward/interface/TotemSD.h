@@ -22,11 +22,7 @@
 
 // user include files
 
-#include "SimG4Core/Notification/interface/Observer.h"
-#include "SimG4Core/SensitiveDetector/interface/SensitiveTkDetector.h"
-#include "SimG4Core/Notification/interface/BeginOfEvent.h"
-#include "SimG4Core/Notification/interface/EndOfEvent.h"
-
+#include "SimG4CMS/Forward/interface/ForwardTkSD.h"
 #include "SimG4CMS/Forward/interface/TotemG4Hit.h"
 #include "SimG4CMS/Forward/interface/TotemG4HitCollection.h"
 #include "SimG4CMS/Forward/interface/TotemVDetectorOrganization.h"
@@ -37,11 +33,9 @@
  
 #include <string>
 
-class TrackingSlaveSD;
+class TotemSD : public ForwardTkSD<TotemSD,TotemG4Hit> {
 
-class TotemSD : public SensitiveTkDetector,
-		public Observer<const BeginOfEvent*>,
-		public Observer<const EndOfEvent*> {
+  friend class ForwardTkSD<TotemSD,TotemG4Hit>;
 
 public:
 
@@ -52,36 +46,21 @@ public:
   virtual bool   ProcessHits(G4Step *,G4TouchableHistory *);
   virtual uint32_t setDetUnitId(G4Step*);
 
-  virtual void   Initialize(G4HCofThisEvent * HCE);
   virtual void   EndOfEvent(G4HCofThisEvent * eventHC);
-  virtual void   clear();
-  virtual void   DrawAll();
-  virtual void   PrintAll();
-
-  void fillHits(edm::PSimHitContainer&, std::string use);
-
-private:
-
-  void           update(const BeginOfEvent *);
-  void           update(const ::EndOfEvent *);
-  virtual void   clearHits();
 
 private:
 
   G4ThreeVector  SetToLocal(const G4ThreeVector& globalPoint);
   void           GetStepInfo(G4Step* aStep);
-  bool           HitExists();
   void           CreateNewHit();
   void           CreateNewHitEvo();
   G4ThreeVector  PosizioEvo(const G4ThreeVector&,double ,double ,double, double,int&);
   void           UpdateHit();
-  void           StoreHit(TotemG4Hit*);
   void           ResetForNewPrimary();
   void           Summarize();
 
 private:
 
-  TrackingSlaveSD*            slave;
   TotemVDetectorOrganization* numberingScheme;
 
   // Data relative to primary particle (the one which triggers a shower)
@@ -91,25 +70,6 @@ private:
 
   G4ThreeVector               entrancePoint;
   float                       incidentEnergy;
-  G4int                       primID  ; //@@ ID of the primary particle.
-
-  std::string                 name;
-  G4int                       hcID;
-  TotemG4HitCollection*       theHC; 
-  const SimTrackManager*      theManager;
-
-  int                         tsID; 
-  TotemG4Hit*                 currentHit;
-  G4Track*                    theTrack;
-  G4VPhysicalVolume*          currentPV;
-  uint32_t                    unitID, previousUnitID;
-  int                         primaryID, tSliceID;  
-  double                      tSlice;
-
-  G4StepPoint*                preStepPoint; 
-  G4StepPoint*                postStepPoint; 
-  float                       edeposit;
-  G4ThreeVector               hitPoint;
 
   G4ThreeVector               Posizio;
   float                       Pabs;
@@ -122,8 +82,6 @@ private:
 
   int                         ParentId;
   float                       Vx,Vy,Vz;
-
-  int                         eventno;
 };
 
 #endif
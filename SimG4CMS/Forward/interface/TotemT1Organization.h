@@ -24,6 +24,7 @@
 // user include files
 
 #include "SimG4CMS/Forward/interface/TotemVDetectorOrganization.h"
+#include "SimG4CMS/Forward/interface/ForwardTouchableDecoder.h"
 #include "globals.hh"
 
 class TotemT1Organization : public TotemVDetectorOrganization {
@@ -108,6 +109,8 @@ private:
   int              _currentCSC;
   int              _currentLayer;
   ObjectType       _currentObjectType;
+  // declares the TotemT1 volumes; caches the unit IDs of the touchable paths
+  ForwardTouchableDecoder _decoder;
 
 };
 #endif
@@ -23,6 +23,8 @@
 
 // user include files
 #include "SimG4CMS/Forward/interface/TotemVDetectorOrganization.h"
+#include "SimG4CMS/Forward/interface/ForwardTouchableDecoder.h"
+
 class TotemT2OrganizationGem : public TotemVDetectorOrganization {
 
 public:
@@ -45,6 +47,8 @@ private:
   int              _currentPlane;
   int              _currentCSC;
   int              _currentLayer;
+  // leaf volumes tagged by their entry in the unit table
+  ForwardTouchableDecoder _decoder;
 
 };
 
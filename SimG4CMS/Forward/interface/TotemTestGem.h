@@ -27,6 +27,7 @@
 // user include files
 #include "SimG4Core/Notification/interface/Observer.h"
 #include "SimG4Core/Notification/interface/BeginOfJob.h"
+#include "SimG4Core/Notification/interface/BeginOfRun.h"
 #include "SimG4Core/Notification/interface/BeginOfEvent.h"
 #include "SimG4Core/Notification/interface/EndOfEvent.h"
 #include "SimG4Core/Watcher/interface/SimProducer.h"
@@ -38,6 +39,7 @@
 class G4Step;
 
 class TotemTestGem : public SimProducer,
+		     public Observer<const BeginOfRun *>,
 		     public Observer<const BeginOfEvent *>,
 		     public Observer<const EndOfEvent *> {
 
@@ -50,18 +52,20 @@ public:
 
 private:
   // observer classes
+  void update(const BeginOfRun * run);
   void update(const BeginOfEvent * evt);
   void update(const EndOfEvent * evt);
 
   void clear();
-  void fillEvent(TotemTestHistoClass&);
 
 private:
 
-  //Keep parameters and internal memory
+  //Keep parameters and internal memory; the product is filled at the end
+  //of the event (so no Geant4 hit is kept) and handed over in produce
   std::vector<std::string>                names;
+  std::vector<int>                        hcIDs;
   int                                     evtnum;
-  std::vector<TotemG4Hit*>                hits;
+  std::auto_ptr<TotemTestHistoClass>      product;
  
 };
 
@@ -0,0 +1,93 @@
+#ifndef Forward_TotemUnitIDCodec_h
+#define Forward_TotemUnitIDCodec_h 1
+// -*- C++ -*-
+//
+// Package:     Forward
+// Class  :     TotemUnitIDCodec
+//
+/**\class TotemUnitIDCodec TotemUnitIDCodec.h SimG4CMS/Forward/interface/TotemUnitIDCodec.h
+
+ Description: Integer exact encoding and decoding of the TotemT1 unit IDs.
+              The layout is the one TotemT1Organization has always
+              written, so existing IDs decode unchanged:
+                position*100000 + 5*(csc + 7*(objectType + 15*pl))
+              where pl is the Cantor pairing of plane and layer (formerly
+              done by TotemNumberMerger). All fields are the stored (non
+              negative) values: plane, csc and layer are shifted by one so
+              that 0 means undefined.
+
+ Usage:
+    Used in TotemT1Organization; decode(ids, n, fields) decodes a whole
+    collection of unit IDs, e.g. in analysis loops
+
+*/
+
+#include <cmath>
+#include <stdint.h>
+
+class TotemUnitIDCodec {
+
+public:
+
+  // ---------- T1 layout ----------------------------------
+  static constexpr uint32_t kPositions    = 5;
+  static constexpr uint32_t kPositionUnit = 100000;
+  static constexpr uint32_t kCSCs         = 7;
+  static constexpr uint32_t kObjectTypes  = 15;
+  // largest stored plane and layer the layout holds together (5 planes,
+  // layers up to 12)
+  static constexpr uint32_t kMaxPlane     = 5;
+  static constexpr uint32_t kMaxLayer     = 13;
+
+  struct T1Fields {
+    uint32_t position, plane, csc, layer, objectType;
+  };
+
+  // ---------- Cantor pairing -----------------------------
+  static constexpr uint32_t merge(uint32_t value1, uint32_t value2) {
+    return (((value1+value2)*(value1+value2+1))>>1)+value1;
+  }
+
+  static void split(uint32_t source, uint32_t & value1, uint32_t & value2) {
+    // the floating point estimate is corrected to the exact integer root
+    uint64_t c = static_cast<uint64_t>((std::sqrt(8.*source+1.)-1.)*0.5);
+    while (((c*(c+1))>>1) > source) --c;
+    while ((((c+1)*(c+2))>>1) <= source) ++c;
+    value1 = static_cast<uint32_t>(source-((c*(c+1))>>1));
+    value2 = static_cast<uint32_t>(c-value1);
+  }
+
+  // ---------- T1 unit IDs --------------------------------
+  // true if the fields can be encoded without overlapping each other
+  static constexpr bool fits(uint32_t position, uint32_t plane, uint32_t csc,
+                             uint32_t layer, uint32_t objectType) {
+    return (position < kPositions && csc < kCSCs && objectType < kObjectTypes &&
+            5*(kCSCs*kObjectTypes*merge(plane, layer)+kCSCs*kObjectTypes) <= kPositionUnit);
+  }
+
+  static constexpr uint32_t encode(uint32_t position, uint32_t plane, uint32_t csc,
+                                   uint32_t layer, uint32_t objectType) {
+    return position*kPositionUnit+5*(csc+kCSCs*(objectType+kObjectTypes*merge(plane, layer)));
+  }
+
+  static void decode(uint32_t id, T1Fields & f) {
+    f.position       = (id/kPositionUnit)%kPositions;
+    uint32_t rest    = (id%kPositionUnit)/5;
+    f.csc            = rest%kCSCs;
+    rest            /= kCSCs;
+    f.objectType     = rest%kObjectTypes;
+    split(rest/kObjectTypes, f.plane, f.layer);
+  }
+
+  static void decode(const uint32_t * ids, unsigned int n, T1Fields * fields) {
+    for (unsigned int k = 0; k < n; ++k) decode(ids[k], fields[k]);
+  }
+};
+
+static_assert(TotemUnitIDCodec::fits(TotemUnitIDCodec::kPositions-1, TotemUnitIDCodec::kMaxPlane,
+                                     TotemUnitIDCodec::kCSCs-1, TotemUnitIDCodec::kMaxLayer,
+                                     TotemUnitIDCodec::kObjectTypes-1),
+              "TotemT1 unit ID fields overlap");
+static_assert(uint64_t(TotemUnitIDCodec::kPositions)*TotemUnitIDCodec::kPositionUnit <= 0xFFFFFFFFull,
+              "TotemT1 unit ID does not fit 32 bits");
+#endif
@@ -2,13 +2,18 @@
 // File: ZdcNumberingScheme.h
 // Date: 03.06
 // Description: Numbering scheme for Zdc
-// Modifications:
+// Modifications: logical volumes resolved once; decoded touchable paths
+//                are kept in a small cache
 ///////////////////////////////////////////////////////////////////////////////
 #undef debug
 #ifndef ZdcNumberingScheme_h
 #define ZdcNumberingScheme_h
 
 #include "G4Step.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <stdint.h>
 
 class ZdcNumberingScheme {
 
@@ -30,12 +35,33 @@ public:
   static void unpackZdcIndex(const unsigned int& idx, int& subDet, int& layer, int& fiber,
                              int& channel, int& z);
 
+  typedef G4LogicalVolume*   lvp;
+  typedef G4VPhysicalVolume* pvp;
+
   int  detectorLevel(const G4Step*) const;
-  void detectorLevel(const G4Step*, int&, int*, G4String*) const;
+  // physical volumes and copy numbers from the ZDC envelope down to the
+  // leaf (at most maxLevel levels)
+  void detectorLevel(const G4Step*, int&, int*, pvp*) const;
 
 private:
 
-  int verbosity;
+  // detector id from the volumes of a touchable path
+  uint32_t decode(int level, const int* copyno, const pvp* pvs) const;
+
+  static const int maxLevel = 20;
+  static const int nCache   = 64;     // power of 2
+
+  struct CacheEntry {
+    int      level;
+    uint32_t id;
+    int      copyno[maxLevel];
+    pvp      pvs[maxLevel];
+  };
+
+  int                verbosity;
+  lvp                lvZDC, lvEMLayer, lvEMFiber, lvRPDPad, lvRPDRadiator;
+  lvp                lvHadLayer, lvHadFiber;
+  mutable CacheEntry cache[nCache];
 
 };
 
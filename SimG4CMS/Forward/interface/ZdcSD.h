@@ -9,6 +9,9 @@
 #include "SimG4CMS/Calo/interface/CaloSD.h"
 #include "SimG4CMS/Forward/interface/ZdcShowerLibrary.h"
 #include "SimG4CMS/Forward/interface/ZdcNumberingScheme.h"
+#include "SimG4CMS/Forward/interface/QuartzFiberResponse.h"
+#include "SimG4CMS/Forward/interface/LibraryHitAccumulator.h"
+#include "G4LogicalVolume.hh"
 #undef debug
 
 class ZdcSD : public CaloSD {
@@ -37,8 +40,9 @@ private:
   double zdcHitEnergyCut;
   ZdcShowerLibrary *    showerLibrary;
   ZdcNumberingScheme * numberingScheme;
-
-  std::vector<ZdcShowerLibrary::Hit> hits;
+  ZdcFiberResponse     fiberResponse;        // quartz fibers at thFibDir
+  LibraryHitAccumulator libraryHits;       // per channel sums of a library shower
+  G4LogicalVolume      *lvEMFiber, *lvHadFiber;
 
 };
 
@@ -0,0 +1,45 @@
+#ifndef SimG4CMS_ZdcShowerFluctuation_h
+#define SimG4CMS_ZdcShowerFluctuation_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerFluctuation.h
+// Description: Samples the photon yield of all channels of a ZDC library
+//              shower in one call. Gaussian (EM) and Landau (HAD) variates
+//              are obtained by inverting tabulated cumulative distributions,
+//              truncated at the upper limit without rejection loops. The
+//              uniform numbers come from the engine in use (the one of the
+//              RandomNumberGenerator service) in a single flatArray call.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+namespace CLHEP {
+  class HepRandomEngine;
+}
+
+class ZdcShowerFluctuation {
+
+public:
+
+  // same codes as the edis value of the parametrization
+  enum Distribution { Gauss = 1, Landau = 3 };
+
+  ZdcShowerFluctuation();
+  ~ZdcShowerFluctuation();
+
+  // number of photons for n channels with response fact[i] to a shower of
+  // average eav and spread esig; each value is limited to eav+5*esig
+  void                  shoot(CLHEP::HepRandomEngine* engine, int edis, double eav,
+                              double esig, int n, const float* fact, int* nphot);
+
+private:
+
+  double                cdf(int dist, double x) const;
+  double                quantile(int dist, double u) const;
+
+  static const int      nTable = 8192;
+  static const int      nMax   = 64;
+  double                uLow, uHigh;
+  std::vector<float>    qGauss, qLandau;  // quantiles at u = k/nTable
+  double                uniform[nMax];
+};
+#endif
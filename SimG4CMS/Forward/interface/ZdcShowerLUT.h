@@ -0,0 +1,53 @@
+#ifndef SimG4CMS_ZdcShowerLUT_h
+#define SimG4CMS_ZdcShowerLUT_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerLUT.h
+// Description: Lookup table of the ZDC shower parametrization. Average
+//              signal (eav) and its spread (esig) are tabulated per particle
+//              class as a function of log(energy) and of the entry point
+//              (x,y) and linearly interpolated. Outside the tabulated range
+//              the closed-form parametrization is evaluated directly.
+//              Units: energy in GeV, x and y in cm relative to the ZDC centre.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+
+class ZdcShowerLUT {
+
+public:
+
+  enum ParticleClass { EM = 0, HAD = 1, NClass = 2 };
+
+  ZdcShowerLUT();
+  ~ZdcShowerLUT();
+
+  // tabulate the parametrization on the default grid
+  void                fill();
+  // binary on-disk form (see zdcLutTableGen.C); return false on failure
+  bool                load(const std::string & fileName);
+  bool                write(const std::string & fileName) const;
+  bool                isFilled() const { return filled; }
+
+  void                getParameters(int iclass, double energy, double xin, double yin,
+                                    double & eav, double & esig, double & edis) const;
+
+  // closed-form parametrization the table is built from
+  static void         parametrization(int iclass, double energy, double xin, double yin,
+                                      double & eav, double & esig, double & edis);
+
+private:
+
+  static void         energyFactors(int iclass, double energy, double & fav, double & fsig);
+  static void         positionFactors(double xin, double yin, double & fav, double & fsig);
+  void                resize();
+
+  bool                filled;
+  unsigned int        nE, nX, nY;
+  double              logEMin, logEMax, xMin, xMax, yMin, yMax;
+  double              invStepE, invStepX, invStepY;
+  std::vector<double> eDist;     // [class]
+  std::vector<float>  tabE;      // [class][ie][eav,esig]
+  std::vector<float>  tabXY;     // [class][ix][iy][eav,esig]
+};
+#endif
@@ -2,7 +2,10 @@
 #define SimG4CMS_ZdcShowerLibrary_h 1
 ///////////////////////////////////////////////////////////////////////////////
 // File: ZdcShowerLibrary.h
-// Description: Gets information from a shower library
+// Description: Gets information from a shower library: showers recorded
+//              with full simulation (ZdcShowerLibraryMaker) binned in
+//              energy x entry point x particle class, with the tabulated
+//              parametrization where the library has no entry
 // E. Garcia June 2008
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -14,9 +17,12 @@
 #include "G4ThreeVector.hh"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 #include "DataFormats/HcalDetId/interface/HcalZDCDetId.h"
+#include "SimG4CMS/Forward/interface/ZdcShowerLUT.h"
+#include "SimG4CMS/Forward/interface/ZdcShowerFluctuation.h"
  
 #include <string>
 #include <memory>
+#include <vector>
 
 class G4Step;
 class DDCompactView;    
@@ -30,36 +36,73 @@ public:
   
  public:
   
-  struct Hit {
-    Hit() {}
-    G4ThreeVector             entryLocal;
-    G4ThreeVector             position;
-    int                       depth;
+  // number of channels in each section and in the whole ZDC
+  static const int nEMChannels  = sizeof(theXChannelBoundaries)/sizeof(double);
+  static const int nHADChannels = sizeof(theZHadChannelBoundaries)/sizeof(double);
+  static const int nRPDChannels = (sizeof(theXrpdChannelBoundaries)/sizeof(double))*
+                                  (sizeof(theYrpdChannelBoundaries)/sizeof(double));
+  static const int nChannels    = nEMChannels + nHADChannels + nRPDChannels;
+
+  // Hits of one library shower: at most one per channel, channels with no
+  // signal are not stored. All hits of a shower share the same time slice.
+  struct Hits {
+    Hits() : nHit(0), time(0) {}
+    int                       nHit;
     double                    time;
-    int                       detID;
-    double                    DeHad;
-    double                    DeEM;
+    int                       index[nChannels];    // channel index, see position()
+    uint32_t                  detID[nChannels];
+    double                    DeHad[nChannels];
+    double                    DeEM[nChannels];
   };
 
-
   void                        initRun(G4ParticleTable * theParticleTable);
-  std::vector<Hit>&           getHits(G4Step * aStep, bool & ok);
-  int                         getEnergyFromLibrary(const G4ThreeVector& posHit, const G4ThreeVector& momDir, double energy,
-                                                   G4int parCode,HcalZDCDetId::Section section, bool side, int channel);
-  int                         photonFluctuation(double eav, double esig,double edis);
+  const Hits&                 getHits(G4Step * aStep, bool & ok);
+  const G4ThreeVector&        position(int index, bool side) const { return chPosition[side][index]; }
+  const G4ThreeVector&        entryLocal(int index, bool side) const { return chEntryLocal[side][index]; }
+  void                        getParametersFromLibrary(const G4ThreeVector& posHit, double energy, int iparCode,
+                                                       double& eav, double& esig, double& edis);
+  float                       channelResponse(const G4ThreeVector& posHit, int iparCode,
+                                              HcalZDCDetId::Section section, int channel) const;
   int                         encodePartID(G4int parCode);
+
+  // index in the channel table of a ZDC unit (-1 if it is not a channel)
+  static int                  channelIndex(const HcalZDCDetId& id);
   
  protected:
 
 private:
 
+  void                        loadLibrary(const std::string& fileName);
+  bool                        sampleLibrary(const G4ThreeVector& posHit, double energy, int iparCode,
+                                            double* dE);
+  void                        matchParametrization(int nE, int nX, int nY);
+  static int                  findBin(const std::vector<double>& edges, double value);
+
   bool                        verbose;
   G4int                         emPDG, epPDG, gammaPDG;
   G4int                         pi0PDG, etaPDG, nuePDG, numuPDG, nutauPDG;
   G4int                         anuePDG, anumuPDG, anutauPDG, geantinoPDG;
 
-  int                         npe;
-  std::vector<ZdcShowerLibrary::Hit> hits;
+  std::string                 lutFile, libFile;
+  double                      rpdHadResponse;  // hadronic signal share per RPD pad
+  double                      paramScale[ZdcShowerLUT::NClass];  // parametrization to library scale
+  ZdcShowerLUT                lut;
+  ZdcShowerFluctuation        fluctuation;
+
+  // pre-simulated showers, sorted by bin
+  std::vector<double>         libEBins, libXBins, libYBins;  // bin edges (GeV, cm, cm)
+  std::vector<int>            libBinStart;    // first shower of bin [class][e][x][y]
+  std::vector<float>          libEnergy;      // incident energy (GeV) of each shower
+  std::vector<float>          libNpe;         // photoelectrons [shower][channel]
+
+  // channel table, built once: [side][channel index]
+  HcalZDCDetId::Section       chSection[nChannels];
+  int                         chNumber[nChannels];
+  G4ThreeVector               chPosition[2][nChannels];
+  G4ThreeVector               chEntryLocal[2][nChannels];
+  uint32_t                    chDetID[2][nChannels];
+
+  Hits                        hits;
   
 };
 #endif
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerLibraryMaker.h
+// Description: Records showers of single particles fully simulated in the
+//              ZDC (ZdcSD with UseShowerHits) into a shower library file
+//              for ZdcShowerLibrary: for each event the class and energy of
+//              the primary, its entry point on the ZDC and the signal of
+//              every EM, HAD and RPD channel
+///////////////////////////////////////////////////////////////////////////////
+#ifndef ZdcShowerLibraryMaker_h
+#define ZdcShowerLibraryMaker_h
+
+#include "SimG4Core/Notification/interface/BeginOfRun.h"
+#include "SimG4Core/Notification/interface/BeginOfEvent.h"
+#include "SimG4Core/Notification/interface/EndOfEvent.h"
+#include "SimG4Core/Notification/interface/Observer.h"
+#include "SimG4Core/Watcher/interface/SimWatcher.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "SimG4CMS/Forward/interface/ZdcShowerLibrary.h"
+
+#include "G4LogicalVolume.hh"
+#include "G4Step.hh"
+
+#include <string>
+#include <vector>
+
+class TFile;
+class TTree;
+
+class ZdcShowerLibraryMaker : public SimWatcher,
+                              public Observer<const BeginOfRun *>,
+                              public Observer<const BeginOfEvent *>,
+                              public Observer<const EndOfEvent *>,
+                              public Observer<const G4Step *> {
+
+public:
+  ZdcShowerLibraryMaker(const edm::ParameterSet &p);
+  virtual ~ZdcShowerLibraryMaker();
+
+private:
+  // observer classes
+  void update(const BeginOfRun * run);
+  void update(const BeginOfEvent * evt);
+  void update(const EndOfEvent * evt);
+  void update(const G4Step * step);
+
+  static const int nChannels = ZdcShowerLibrary::nChannels;
+
+  int                                  verbosity;
+  std::string                          fileName, hitCollection;
+  int                                  hcID;                 // of hitCollection
+  std::vector<double>                  eBins, xBins, yBins;  // GeV, cm, cm
+  std::vector<const G4LogicalVolume*>  lvZdc;                // sorted
+  TFile                               *file;
+  TTree                               *tree;
+  int                                  nStored;
+
+  // shower of the current event
+  bool                                 entered;
+  int                                  zside, cls, nch;
+  float                                energy, x, y, npe[nChannels];
+};
+
+#endif // ZdcShowerLibraryMaker_h
@@ -0,0 +1,87 @@
+#ifndef SimG4CMS_ZdcStepRecorder_h
+#define SimG4CMS_ZdcStepRecorder_h
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcStepRecorder.h
+// Description: Columnar file of fixed width step records (one float per
+//              column) for ZdcTestAnalysis. Records go into a ring of
+//              blocks; full blocks are compressed (zlib, column by column)
+//              and written by a background thread, so the stepping only
+//              copies the record. When all blocks wait for the writer the
+//              stepping waits too, nothing is dropped.
+//              Also used by ForwardCaloSummary. Files are converted into
+//              an ntuple (NTzdcstep by default) by the zdcStepRecordToNtuple
+//              tool.
+//
+//              Layout (native byte order, version 1):
+//                char   magic[8] = "ZDCSTEPS"
+//                uint32 version, nColumns
+//                for each column: uint32 length, char name[length]
+//                blocks until the end of the file:
+//                  uint32 nRows
+//                  for each column: uint32 nBytes, zlib data of
+//                                   float[nRows]
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ZdcStepRecorder {
+
+public:
+
+  // blockRows records per block, nBlocks blocks in the ring; compression
+  // is the zlib level
+  ZdcStepRecorder(const std::string & fileName,
+                  const std::vector<std::string> & columns,
+                  unsigned int blockRows=65536, unsigned int nBlocks=4,
+                  int compression=1);
+  ~ZdcStepRecorder();
+
+  // false if the file could not be opened or written (also after close)
+  bool                  good() const;
+  // copies one record (one value per column)
+  void                  fill(const float * record);
+  // writes the pending records and closes the file
+  void                  close();
+  unsigned long         records() const { return nRecords; }
+
+  // reads a whole file; data[column][record]
+  static bool           read(const std::string & fileName,
+                             std::vector<std::string> & columns,
+                             std::vector<std::vector<float> > & data,
+                             std::string & error);
+
+private:
+
+  struct Block {
+    unsigned int        nRows;
+    std::vector<float>  data;       // [column*blockRows+row]
+  };
+
+  void                  submit();
+  void                  writeLoop();
+  bool                  writeBlock(const Block & block, std::vector<unsigned char> & buffer);
+
+  static const char     fileMagic[8];
+  static const uint32_t fileVersion = 1;
+
+  std::FILE            *file;
+  unsigned int          nColumns, blockRows;
+  int                   compression;
+  unsigned long         nRecords;
+
+  std::vector<Block>    blocks;
+  Block                *current;
+  std::deque<Block*>    toWrite, toFill;
+  mutable std::mutex    lock;
+  std::condition_variable changed;
+  bool                  stopping, failed;
+  std::thread           writer;
+};
+#endif
@@ -55,12 +55,14 @@
 
 
 
+class G4LogicalVolume;
 class G4Step;
 class BeginOfJob;
 class BeginOfRun;
 class EndOfRun;
 class BeginOfEvent;
 class EndOfEvent;
+class ZdcStepRecorder;
 
 class ZdcTestAnalysis : public SimWatcher,
 			public Observer<const BeginOfJob *>, 
@@ -88,6 +90,7 @@ private:
   void   finish();
 
   int verbosity;
+  // 1: step ntuple; 2: compressed step records (ZdcStepRecorder)
   int doNTzdcstep;
   int doNTzdcevent;
   std::string stepNtFileName;
@@ -95,6 +98,7 @@ private:
 
   TFile* zdcOutputEventFile;
   TFile* zdcOutputStepFile;
+  ZdcStepRecorder* zdcStepRecorder;
 
   TNtuple* zdcstepntuple;
   TNtuple* zdceventntuple;
@@ -105,6 +109,9 @@ private:
   Float_t zdcsteparray[18];
   Float_t zdceventarray[16];
 
+  // type of the step volume (ntuple pvtype) by logical volume
+  std::vector<std::pair<const G4LogicalVolume*,int> > pvTypes;
+
 };
 
 #endif // ZdcTestAnalysis_h
@@ -4,7 +4,9 @@
 #include "SimG4CMS/Forward/interface/TotemTestGem.h"
 #include "SimG4CMS/Forward/interface/CastorTestAnalysis.h"
 #include "SimG4CMS/Forward/interface/ZdcTestAnalysis.h"
+#include "SimG4CMS/Forward/interface/ZdcShowerLibraryMaker.h"
 #include "SimG4CMS/Forward/interface/DoCastorAnalysis.h"
+#include "SimG4CMS/Forward/interface/ForwardCaloSummary.h"
 #include "SimG4CMS/Forward/interface/PltSD.h"
 #include "SimG4CMS/Forward/interface/FastTimerSD.h"
 
@@ -35,6 +37,8 @@ typedef Bcm1fSD BCM1FSensitiveDetector;
 DEFINE_SENSITIVEDETECTOR(BCM1FSensitiveDetector);
 DEFINE_SIMWATCHER (CastorTestAnalysis);
 DEFINE_SIMWATCHER (ZdcTestAnalysis);
+DEFINE_SIMWATCHER (ZdcShowerLibraryMaker);
 DEFINE_SIMWATCHER (DoCastorAnalysis);
+DEFINE_SIMWATCHER (ForwardCaloSummary);
 DEFINE_SIMWATCHER (TotemTestGem);
 DEFINE_SIMWATCHER (BscTest);
@@ -105,6 +105,11 @@ process.g4SimHits.Watchers = cms.VPSet(cms.PSet(
         UseShowerLibrary    = cms.bool(False),
         EventNtupleFlag     = cms.int32(1)
     )
+), cms.PSet(
+    type = cms.string('ForwardCaloSummary'),
+    ForwardCaloSummary = cms.PSet(
+        FileName = cms.string('forwardCaloSummary_pion.bin')
+    )
 ))
 
 
@@ -0,0 +1,75 @@
+import FWCore.ParameterSet.Config as cms
+
+# Records a ZDC shower library: single particles fully simulated in the
+# ZDC (EM, HAD and RPD), one library shower per event. The gun energy and
+# position should cover the bins below; run once per particle class
+# (e.g. PartID 11 for EM, 2112 for HAD) and merge the outputs with hadd.
+# The library is then used with
+#   process.g4SimHits.ZdcSD.UseShowerLibrary = True
+#   process.g4SimHits.ZdcShowerLibrary.LibraryFile = 'SimG4CMS/Forward/data/zdcShowerLibrary.root'
+
+process = cms.Process('SIM')
+
+# import of standard configurations
+process.load('Configuration/StandardSequences/Services_cff')
+process.load('FWCore/MessageService/MessageLogger_cfi')
+process.load('SimG4CMS.Forward.zdcGeometryXML_cfi')
+process.load('Configuration/StandardSequences/MagneticField_38T_cff')
+process.load('Configuration/StandardSequences/Generator_cff')
+process.load('Configuration/StandardSequences/VtxSmearedNoSmear_cff')
+process.load('Configuration/StandardSequences/Sim_cff')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1000)
+)
+
+# Input source
+process.source = cms.Source("EmptySource")
+
+process.generator = cms.EDProducer("FlatRandomEGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32(2112),
+        MinEta = cms.double(8.5),
+        MaxEta = cms.double(9.5),
+        MinPhi = cms.double(-3.14159265359), ## in radians
+        MaxPhi = cms.double(3.14159265359),
+        MinE = cms.double(100.0),
+        MaxE = cms.double(2500.0)
+    ),
+    Verbosity = cms.untracked.int32(0),
+
+    psethack = cms.string('single neutron E 100-2500'),
+    # one primary per event: the library shower is the one of track 1
+    AddAntiParticle = cms.bool(False),
+    firstRun = cms.untracked.uint32(1)
+)
+
+process.ProductionFilterSequence = cms.Sequence(process.generator)
+
+# Full simulation of the ZDC
+process.g4SimHits.UseMagneticField = cms.bool(False)
+process.g4SimHits.Physics.DefaultCutValue = cms.double(10.)
+process.g4SimHits.Generator.MinEtaCut = cms.double(-9.9)
+process.g4SimHits.Generator.MaxEtaCut =  cms.double(9.9)
+process.g4SimHits.ZdcSD.UseShowerLibrary = cms.bool(False)
+process.g4SimHits.ZdcSD.UseShowerHits = cms.bool(True)
+process.g4SimHits.StackingAction.MaxTrackTime = cms.double(10000.)
+process.g4SimHits.CaloSD.TmaxHit = cms.double(10000.)
+process.g4SimHits.Watchers = cms.VPSet(cms.PSet(
+    type = cms.string('ZdcShowerLibraryMaker'),
+    ZdcShowerLibraryMaker = cms.PSet(
+        Verbosity = cms.untracked.int32(0),
+        FileName = cms.string('zdcShowerLibrary.root'),
+        # bin edges: energy (GeV) and entry point relative to the ZDC centre (cm)
+        EnergyBins = cms.vdouble(100., 200., 400., 700., 1000., 1500., 2000., 2500.),
+        XBins = cms.vdouble(-4.5, -3.0, -1.5, 0.0, 1.5, 3.0, 4.5),
+        YBins = cms.vdouble(-4.5, -3.0, -1.5, 0.0, 1.5, 3.0, 4.5)
+    )
+))
+
+# Path and EndPath definitions
+process.generation_step = cms.Path(process.ProductionFilterSequence+process.pgen)
+process.simulation_step = cms.Path(process.psim)
+
+# Schedule definition
+process.schedule = cms.Schedule(process.generation_step,process.simulation_step)
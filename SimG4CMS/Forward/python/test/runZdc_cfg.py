@@ -61,11 +61,16 @@ process.g4SimHits.Watchers = cms.VPSet(cms.PSet(
     type = cms.string('ZdcTestAnalysis'),
     ZdcTestAnalysis = cms.PSet(
         Verbosity = cms.int32(0),
-		StepNtupleFlag = cms.int32(0),
+		StepNtupleFlag = cms.int32(0), # 1: ntuple, 2: compressed step records
         EventNtupleFlag = cms.int32(1),
         StepNtupleFileName = cms.string('stepNtuple.root'),
         EventNtupleFileName = cms.string('eventNtuple.root')
 	)   	
+), cms.PSet(
+    type = cms.string('ForwardCaloSummary'),
+    ForwardCaloSummary = cms.PSet(
+        FileName = cms.string('forwardCaloSummary.bin')
+    )
 ))
 process.g4SimHits.ZdcSD.UseShowerLibrary = cms.bool(True)
 process.g4SimHits.StackingAction.MaxTrackTime = cms.double(10000.)
@@ -40,21 +40,16 @@ unsigned int BHMNumberingScheme::getUnitID(const G4Step* aStep) const {
   int level = detectorLevel(aStep);
 
   LogDebug("BHMSim") << "BHMNumberingScheme number of levels= " << level;
-  if (level > 0) {
-    int*      copyno = new int[level];
-    G4String* name   = new G4String[level];
-    detectorLevel(aStep, level, copyno, name);
-
-    if (level > 3) {
-      int subdet  = copyno[0];
-      int zside   = copyno[3];
-      int station = copyno[1];
-      intindex = packIndex (subdet, zside, station);
-      LogDebug("BHMSim") << "BHMNumberingScheme : subdet " << subdet 
-			 << " zside "  << zside << " station " << station; 
-    }
-    delete[] copyno;
-    delete[] name;
+  // only copy numbers counted from the top of the history are used: read
+  // them directly rather than the names and copy numbers of all levels
+  if (level > 3) {
+    const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
+    int subdet  = touch->GetReplicaNumber(level-1);
+    int zside   = touch->GetReplicaNumber(level-4);
+    int station = touch->GetReplicaNumber(level-2);
+    intindex = packIndex (subdet, zside, station);
+    LogDebug("BHMSim") << "BHMNumberingScheme : subdet " << subdet 
+		       << " zside "  << zside << " station " << station; 
   }
   LogDebug("BHMSim") << "BHMNumberingScheme : UnitID 0x" << std::hex 
 		     << intindex << std::dec;
@@ -2,7 +2,6 @@
 #include "SimG4Core/Notification/interface/G4TrackToParticleID.h"
 #include "SimG4Core/Physics/interface/G4ProcessTypeEnumerator.h"
 
-#include "SimDataFormats/SimHitMaker/interface/TrackingSlaveSD.h"
 #include "SimDataFormats/TrackingHit/interface/UpdatablePSimHit.h"
 #include "SimG4CMS/Forward/interface/BHMSD.h"
 
@@ -30,18 +29,13 @@
 BHMSD::BHMSD(std::string name, const DDCompactView & cpv,
 	     const SensitiveDetectorCatalog & clg, 
 	     edm::ParameterSet const & p, const SimTrackManager* manager) :
-  SensitiveTkDetector(name, cpv, clg, p), numberingScheme(0), name(name),
-  hcID(-1), theHC(0), theManager(manager), currentHit(0), theTrack(0), 
-  currentPV(0), unitID(0),  previousUnitID(0), preStepPoint(0), 
-  postStepPoint(0), eventno(0){
-    
-  //Add BHM Sentitive Detector Name
-  collectionName.insert(name);
-    
+  ForwardTkSD<BHMSD,BscG4Hit>(name, cpv, clg, p, manager, "BHMSim"),
+  numberingScheme(0) {
     
   //Parameters
   edm::ParameterSet m_p = p.getParameter<edm::ParameterSet>("BHMSD");
   int verbn = m_p.getUntrackedParameter<int>("Verbosity");
+  storeHitDetails = m_p.getUntrackedParameter<bool>("StoreHitDetails", true);
   //int verbn = 1;
     
   SetVerboseLevel(verbn);
@@ -53,21 +47,6 @@ BHMSD::BHMSD(std::string name, const DDCompactView & cpv,
     << "*******************************************************";
     
     
-  slave  = new TrackingSlaveSD(name);
-    
-  //
-  // attach detectors (LogicalVolumes)
-  //
-  std::vector<std::string> lvNames = clg.logicalNames(name);
-
-  this->Register();
-
-  for (std::vector<std::string>::iterator it=lvNames.begin();  
-       it !=lvNames.end(); it++) {
-    this->AssignSD(*it);
-    edm::LogInfo("BHMSim") << "BHMSD : Assigns SD to LV " << (*it);
-  }
-    
   if (verbn > 0) {
     edm::LogInfo("BHMSim") << "name = " <<name <<" and new BHMNumberingScheme";
   }
@@ -79,7 +58,6 @@ BHMSD::BHMSD(std::string name, const DDCompactView & cpv,
 
 BHMSD::~BHMSD() { 
 
-  if (slave)           delete slave; 
   if (numberingScheme) delete numberingScheme;
 }
 
@@ -87,21 +65,6 @@ double BHMSD::getEnergyDeposit(G4Step* aStep) {
   return aStep->GetTotalEnergyDeposit();
 }
 
-void BHMSD::Initialize(G4HCofThisEvent * HCE) { 
-#ifdef debug
-  LogDebug("BHMSim") << "BHMSD : Initialize called for " << name << std::endl;
-#endif
-
-  theHC = new BscG4HitCollection(name, collectionName[0]);
-  if (hcID<0) 
-    hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  HCE->AddHitsCollection(hcID, theHC);
-
-  tsID   = -2;
-  primID = -2;
-}
-
-
 bool BHMSD::ProcessHits(G4Step * aStep, G4TouchableHistory * ) {
 
   if (aStep == NULL) {
@@ -161,9 +124,6 @@ void BHMSD::GetStepInfo(G4Step* aStep) {
   Vx = theTrack->GetVertexPosition().x();
   Vy = theTrack->GetVertexPosition().y();
   Vz = theTrack->GetVertexPosition().z();
-  X  = hitPoint.x();
-  Y  = hitPoint.y();
-  Z  = hitPoint.z();
 }
 
 uint32_t BHMSD::setDetUnitId(G4Step * aStep) { 
@@ -171,46 +131,6 @@ uint32_t BHMSD::setDetUnitId(G4Step * aStep) {
 }
 
 
-G4bool BHMSD::HitExists() {
-  if (primaryID<1) {
-    edm::LogWarning("BHMSim") << "***** BHMSD error: primaryID = " 
-				  << primaryID
-				  << " maybe detector name changed";
-  }
-
-  // Update if in the same detector, time-slice and for same track   
-  if (tSliceID == tsID && unitID==previousUnitID) {
-    UpdateHit();
-    return true;
-  }
-  // Reset entry point for new primary
-  if (primaryID != primID)
-    ResetForNewPrimary();
-   
-  //look in the HitContainer whether a hit with the same primID, unitID,
-  //tSliceID already exists:
-   
-  G4bool found = false;
-
-  for (int j=0; j<theHC->entries()&&!found; j++) {
-    BscG4Hit* aPreviousHit = (*theHC)[j];
-    if (aPreviousHit->getTrackID()     == primaryID &&
-	aPreviousHit->getTimeSliceID() == tSliceID  &&
-	aPreviousHit->getUnitID()      == unitID       ) {
-      currentHit = aPreviousHit;
-      found      = true;
-    }
-  }          
-
-  if (found) {
-    UpdateHit();
-    return true;
-  } else {
-    return false;
-  }    
-}
-
-
 void BHMSD::ResetForNewPrimary() {
   
   entrancePoint  = SetToLocal(hitPoint);
@@ -219,18 +139,6 @@ void BHMSD::ResetForNewPrimary() {
 }
 
 
-void BHMSD::StoreHit(BscG4Hit* hit){
-
-  if (primID<0) return;
-  if (hit == 0 ) {
-    edm::LogWarning("BHMSim") << "BHMSD: hit to be stored is NULL !!";
-    return;
-  }
-
-  theHC->insert( hit );
-}
-
-
 void BHMSD::CreateNewHit() {
 
 #ifdef debug
@@ -272,17 +180,15 @@ void BHMSD::CreateNewHit() {
 
   currentHit->setEntry(hitPoint);
 
-  currentHit->setEntryLocalP(hitPointLocal);
-  currentHit->setExitLocalP(hitPointLocalExit);
-
-  currentHit->setParentId(ParentId);
-  currentHit->setVx(Vx);
-  currentHit->setVy(Vy);
-  currentHit->setVz(Vz);
+  if (storeHitDetails) {
+    currentHit->setEntryLocalP(hitPointLocal);
+    currentHit->setExitLocalP(hitPointLocalExit);
 
-  currentHit->setX(X);
-  currentHit->setY(Y);
-  currentHit->setZ(Z);
+    currentHit->setParentId(ParentId);
+    currentHit->setVx(Vx);
+    currentHit->setVy(Vy);
+    currentHit->setVz(Vz);
+  }
 
   UpdateHit();
   
@@ -357,31 +263,6 @@ void BHMSD::Summarize() {
 }
 
 
-void BHMSD::clear() {
-} 
-
-
-void BHMSD::DrawAll() {
-} 
-
-
-void BHMSD::PrintAll() {
-  LogDebug("BHMSim") << "BHMSD: Collection " << theHC->GetName() << "\n";
-  theHC->PrintAllHits();
-} 
-
-
-void BHMSD::fillHits(edm::PSimHitContainer& c, std::string n) {
-  if (slave->name() == n) c=slave->hits();
-}
-
-void BHMSD::update (const BeginOfEvent * i) {
-  LogDebug("BHMSim") << " Dispatched BeginOfEvent for " << GetName()
-                       << " !" ;
-   clearHits();
-   eventno = (*i)()->GetEventID();
-}
-
 void BHMSD::update(const BeginOfRun *) {
 
   G4ParticleTable * theParticleTable = G4ParticleTable::GetParticleTable();
@@ -392,15 +273,3 @@ void BHMSD::update(const BeginOfRun *) {
 
 } 
 
-void BHMSD::update (const ::EndOfEvent*) {
-}
-
-void BHMSD::clearHits(){
-  slave->Initialize();
-}
-
-std::vector<std::string> BHMSD::getNames(){
-  std::vector<std::string> temp;
-  temp.push_back(slave->name());
-  return temp;
-}
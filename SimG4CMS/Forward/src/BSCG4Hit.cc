@@ -6,10 +6,11 @@
 #include "SimG4CMS/Forward/interface/BscG4Hit.h"
 #include <iostream>
 
-BscG4Hit::BscG4Hit():entry(0) {
+G4ThreadLocal G4Allocator<BscG4Hit>* fpBscG4HitAllocator = 0;
 
-  entrylp(0);
-  exitlp(0);
+BscG4Hit::BscG4Hit() : theDetails(0) {
+
+  setEntry(G4ThreeVector());
   elem     = 0.;
   hadr     = 0.;
   theIncidentEnergy = 0.;
@@ -20,56 +21,21 @@ BscG4Hit::BscG4Hit():entry(0) {
   theTof=0. ;
   theEnergyLoss=0.   ;
   theParticleType=0 ;
-  theUnitID=0;
-  theTrackID=-1;
   theThetaAtEntry=-10000. ;
   thePhiAtEntry=-10000. ;
-  theParentId=0;
-  
-  theX = 0.;
-  theY = 0.;
-  theZ = 0.;
-  theVx = 0.;
-  theVy = 0.;
-  theVz = 0.;
 }
 
 
-BscG4Hit::~BscG4Hit(){}
+BscG4Hit::~BscG4Hit(){ delete theDetails; }
 
 
-BscG4Hit::BscG4Hit(const BscG4Hit &right) {
-  theUnitID         = right.theUnitID;
-  
-  theTrackID        = right.theTrackID;
-  theTof            = right.theTof ;
-  theEnergyLoss      = right.theEnergyLoss   ;
-  theParticleType    = right.theParticleType ;
-  thePabs            = right.thePabs;
-  elem               = right.elem;
-  hadr               = right.hadr;
-  theIncidentEnergy  = right.theIncidentEnergy;
-  theTimeSlice       = right.theTimeSlice;
-  entry              = right.entry;
-  entrylp            = right.entrylp;
-  exitlp             = right.exitlp;
-  theThetaAtEntry    = right.theThetaAtEntry;
-  thePhiAtEntry      = right.thePhiAtEntry;
-  theParentId        = right.theParentId;
-  
-  theX = right.theX;
-  theY = right.theY;
-  theZ = right.theZ;
-  
-  theVx = right.theVx;
-  theVy = right.theVy;
-  theVz = right.theVz;
-  
-  
+BscG4Hit::BscG4Hit(const BscG4Hit &right) : theDetails(0) {
+  *this = right;
 }
 
 
 const BscG4Hit& BscG4Hit::operator=(const BscG4Hit &right) {
+  if (this == &right) return *this;
   theUnitID         = right.theUnitID;
   
   theTrackID        = right.theTrackID;
@@ -81,26 +47,27 @@ const BscG4Hit& BscG4Hit::operator=(const BscG4Hit &right) {
   hadr               = right.hadr;
   theIncidentEnergy  = right.theIncidentEnergy;
   theTimeSlice       = right.theTimeSlice;
-  entry              = right.entry;
-  entrylp            = right.entrylp;
-  exitlp             = right.exitlp;
+  for (int k=0; k<3; ++k) entry[k] = right.entry[k];
   theThetaAtEntry    = right.theThetaAtEntry;
   thePhiAtEntry      = right.thePhiAtEntry;
-  theParentId        = right.theParentId;
-  
-  theX = right.theX;
-  theY = right.theY;
-  theZ = right.theZ;
-  
-  theVx = right.theVx;
-  theVy = right.theVy;
-  theVz = right.theVz;
-  
+
+  if (right.theDetails) {
+    *details() = *right.theDetails;
+  } else {
+    delete theDetails;
+    theDetails = 0;
+  }
   
   return *this;
 }
 
 
+BscG4Hit::Details* BscG4Hit::details() {
+  if (!theDetails) theDetails = new Details;
+  return theDetails;
+}
+
+
 void BscG4Hit::addEnergyDeposit(const BscG4Hit& aHit) {
 
   elem += aHit.getEM();
@@ -112,14 +79,22 @@ void BscG4Hit::Print() {
   std::cout << (*this);
 }
 
-G4ThreeVector   BscG4Hit::getEntry() const           {return entry;}
-void         BscG4Hit::setEntry(const G4ThreeVector& xyz)   { entry    = xyz; }
+G4ThreeVector   BscG4Hit::getEntry() const           {return G4ThreeVector(entry[0],entry[1],entry[2]);}
+void         BscG4Hit::setEntry(const G4ThreeVector& xyz)   { entry[0] = xyz.x(); entry[1] = xyz.y(); entry[2] = xyz.z(); }
 
-G4ThreeVector    BscG4Hit::getEntryLocalP() const           {return entrylp;}
-void         BscG4Hit::setEntryLocalP(const G4ThreeVector& xyz1)   { entrylp    = xyz1; }
+G4ThreeVector    BscG4Hit::getEntryLocalP() const           {
+  return theDetails ? G4ThreeVector(theDetails->entrylp[0],theDetails->entrylp[1],theDetails->entrylp[2]) : G4ThreeVector();
+}
+void         BscG4Hit::setEntryLocalP(const G4ThreeVector& xyz1)   {
+  float * p = details()->entrylp;  p[0] = xyz1.x(); p[1] = xyz1.y(); p[2] = xyz1.z();
+}
 
-G4ThreeVector     BscG4Hit::getExitLocalP() const           {return exitlp;}
-void         BscG4Hit::setExitLocalP(const G4ThreeVector& xyz1)   { exitlp    = xyz1; }
+G4ThreeVector     BscG4Hit::getExitLocalP() const           {
+  return theDetails ? G4ThreeVector(theDetails->exitlp[0],theDetails->exitlp[1],theDetails->exitlp[2]) : G4ThreeVector();
+}
+void         BscG4Hit::setExitLocalP(const G4ThreeVector& xyz1)   {
+  float * p = details()->exitlp;  p[0] = xyz1.x(); p[1] = xyz1.y(); p[2] = xyz1.z();
+}
 
 double       BscG4Hit::getEM() const              {return elem; }
 void         BscG4Hit::setEM (double e)           { elem     = e; }
@@ -161,26 +136,26 @@ float BscG4Hit::getPhiAtEntry() const{ return thePhiAtEntry;}
 void BscG4Hit::setThetaAtEntry(float t){theThetaAtEntry = t;}
 void BscG4Hit::setPhiAtEntry(float f) {thePhiAtEntry = f ;}
 
-float BscG4Hit::getX() const{ return theX;}
-void BscG4Hit::setX(float t){theX = t;}
+float BscG4Hit::getX() const{ return entry[0];}
+void BscG4Hit::setX(float t){entry[0] = t;}
 
-float BscG4Hit::getY() const{ return theY;}
-void BscG4Hit::setY(float t){theY = t;}
+float BscG4Hit::getY() const{ return entry[1];}
+void BscG4Hit::setY(float t){entry[1] = t;}
 
-float BscG4Hit::getZ() const{ return theZ;}
-void BscG4Hit::setZ(float t){theZ = t;}
+float BscG4Hit::getZ() const{ return entry[2];}
+void BscG4Hit::setZ(float t){entry[2] = t;}
 
-int BscG4Hit::getParentId() const {return theParentId;}
-void BscG4Hit::setParentId(int p){theParentId = p;}
+int BscG4Hit::getParentId() const {return theDetails ? theDetails->parentId : 0;}
+void BscG4Hit::setParentId(int p){details()->parentId = p;}
 
-float BscG4Hit::getVx() const{ return theVx;}
-void BscG4Hit::setVx(float t){theVx = t;}
+float BscG4Hit::getVx() const{ return theDetails ? theDetails->vx : 0;}
+void BscG4Hit::setVx(float t){details()->vx = t;}
 
-float BscG4Hit::getVy() const{ return theVy;}
-void BscG4Hit::setVy(float t){theVy = t;}
+float BscG4Hit::getVy() const{ return theDetails ? theDetails->vy : 0;}
+void BscG4Hit::setVy(float t){details()->vy = t;}
 
-float BscG4Hit::getVz() const{ return theVz;}
-void BscG4Hit::setVz(float t){theVz = t;}
+float BscG4Hit::getVz() const{ return theDetails ? theDetails->vz : 0;}
+void BscG4Hit::setVz(float t){details()->vz = t;}
 
 
 
@@ -17,6 +17,7 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include "G4LogicalVolume.hh"
 #include "G4Track.hh"
 #include "G4SDManager.hh"
 #include "G4VProcess.hh"
@@ -36,7 +37,7 @@ Bcm1fSD::Bcm1fSD(std::string name,
 					   edm::ParameterSet const & p,
 					   const SimTrackManager* manager) : 
   SensitiveTkDetector(name, cpv, clg, p), myName(name), mySimHit(0),
-  oldVolume(0), lastId(0), lastTrack(0), eventno(0) {
+  oldVolume(0), lastId(0), currentId(0), lastTrack(0), eventno(0) {
   
   edm::ParameterSet m_TrackerSD = p.getParameter<edm::ParameterSet>("Bcm1fSD");
   energyCut           = m_TrackerSD.getParameter<double>("EnergyThresholdForPersistencyInGeV")*GeV; //default must be 0.5 (?)
@@ -59,6 +60,7 @@ Bcm1fSD::Bcm1fSD(std::string name,
 
   theG4ProcessTypeEnumerator = new G4ProcessTypeEnumerator;
   myG4TrackToParticleID = new G4TrackToParticleID;
+  for (int k = 0; k < 2; ++k) checkedLV[k] = 0;
 }
 
 Bcm1fSD::~Bcm1fSD() { 
@@ -109,18 +111,10 @@ uint32_t Bcm1fSD::setDetUnitId(G4Step * aStep ) {
   int level = 0;
   if (touch) level = ((touch->GetHistoryDepth())+1);
   
-  //Get name and copy numbers
+  //Get copy numbers
   if ( level > 1 ) {
      
-     G4String sensorName   = touch->GetVolume(0)->GetName();
-     G4String diamondName  = touch->GetVolume(1)->GetName();
-     G4String detectorName = touch->GetVolume(2)->GetName();
-     G4String volumeName   = touch->GetVolume(3)->GetName();
-     
-     if ( sensorName != "BCM1FSensor" )
-        std::cout << " Bcm1fSD::setDetUnitId -w- Sensor name not BCM1FSensor " << std::endl;
-     if ( detectorName != "BCM1F" )
-        std::cout << " Bcm1fSD::setDetUnitId -w- Detector name not BCM1F " << std::endl;
+     checkNames(touch);
      
      int sensorNo    = touch->GetReplicaNumber(0);
      int diamondNo   = touch->GetReplicaNumber(1);
@@ -150,6 +144,21 @@ uint32_t Bcm1fSD::setDetUnitId(G4Step * aStep ) {
   return detId;
 }
 
+void Bcm1fSD::checkNames(const G4VTouchable* touch) {
+
+  // names are only compared the first time a logical volume is seen at a level
+  static const int level[2] = {0, 2};
+  static const char * const expected[2] = {"BCM1FSensor", "BCM1F"};
+  for (int k = 0; k < 2; ++k) {
+    const G4VPhysicalVolume * pv = touch->GetVolume(level[k]);
+    if (pv->GetLogicalVolume() == checkedLV[k]) continue;
+    if (pv->GetName() != expected[k])
+      edm::LogWarning("Bcm1fSD") << "Bcm1fSD::setDetUnitId: volume " << pv->GetName()
+                                 << " at level " << level[k] << " is not " << expected[k];
+    checkedLV[k] = pv->GetLogicalVolume();
+  }
+}
+
 void Bcm1fSD::EndOfEvent(G4HCofThisEvent *) {
   
   LogDebug("Bcm1fSD")<< " Saving the last hit in a ROU " << myName;
@@ -197,7 +206,7 @@ void Bcm1fSD::updateHit(G4Step * aStep) {
 bool Bcm1fSD::newHit(G4Step * aStep) {
 
   G4Track * theTrack = aStep->GetTrack(); 
-  uint32_t theDetUnitId = setDetUnitId(aStep);
+  uint32_t theDetUnitId = currentId = setDetUnitId(aStep);
   unsigned int theTrackID = theTrack->GetTrackID();
 
   LogDebug("Bcm1fSD") << " OLD (d,t) = (" << lastId << "," << lastTrack 
@@ -237,7 +246,7 @@ void Bcm1fSD::createHit(G4Step * aStep) {
   float theTof              = aStep->GetPreStepPoint()->GetGlobalTime()/nanosecond;
   float theEnergyLoss       = aStep->GetTotalEnergyDeposit()/GeV;
   int theParticleType       = myG4TrackToParticleID->particleID(theTrack);
-  uint32_t theDetUnitId     = setDetUnitId(aStep);
+  uint32_t theDetUnitId     = currentId; // from newHit for this step
   
   globalEntryPoint = SensitiveDetector::InitialStepPosition(aStep,WorldCoordinates);
   globalExitPoint = SensitiveDetector::FinalStepPosition(aStep,WorldCoordinates);
@@ -12,6 +12,12 @@
 
 BscNumberingScheme::BscNumberingScheme() {
   LogDebug("BscSim") << " Creating BscNumberingScheme" ;
+  decoder.addEnvelope("BSC1",  kBSC1);
+  decoder.addEnvelope("BSC2",  kBSC2);
+  decoder.addVolume("BSCTrap", kBSCTrap);
+  decoder.addVolume("BSCTubs", kBSCTubs);
+  decoder.addVolume("BSCTTop", kBSCTTop);
+  decoder.addVolume("BSC2Pad", kBSC2Pad);
 }
 
 BscNumberingScheme::~BscNumberingScheme() {
@@ -44,55 +50,50 @@ void BscNumberingScheme::detectorLevel(const G4Step* aStep, int& level,
 unsigned int BscNumberingScheme::getUnitID(const G4Step* aStep) const {
 
   unsigned intindex=0;
-  int level = detectorLevel(aStep);
+  const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
+  if (touch == 0) return intindex;
+  if (decoder.find(touch, intindex)) return intindex;
 
+  int level = decoder.levels();
   LogDebug("BscSim") << "BscNumberingScheme number of levels= " << level;
 
- //  unsigned int intIndex = 0;
-  if (level > 0) {
-    int*      copyno = new int[level];
-    G4String* name   = new G4String[level];
-    detectorLevel(aStep, level, copyno, name);
-
-    int det   = 0;
-    int zside   = 0;
-    int station  = 0;
-    for (int ich=0; ich  <  level; ich++) {
-      // new and old set up configurations are possible:
-      if(name[ich] == "BSC1" ||name[ich] == "BSC2" ) {
-	zside   = copyno[ich]-1;
-      } else if(name[ich] == "BSCTrap") {
-	det   = 0;
-        station =  2*(copyno[ich]-1);
-      } else if(name[ich] == "BSCTubs") {
-	det   = 1;
-        station =  copyno[ich]-1;
-      } else if(name[ich] == "BSCTTop") {
-	++station;
-      } else if(name[ich] == "BSC2Pad"){
-	det   = 2;
-        station =  copyno[ich]-1;
-      }
-
-      LogDebug("BscSim") << "BscNumberingScheme  " << "ich=" << ich  <<"copyno"
-			 << copyno[ich] << "name="  << name[ich];
-
+  int det   = 0;
+  int zside   = 0;
+  int station  = 0;
+  // from the BSC1/BSC2 envelope down to the leaf
+  for (int i = level-1; i >= 0; i--) {
+    int copyno = decoder.copyNo(i);
+    // new and old set up configurations are possible:
+    switch (decoder.tag(i)) {
+    case kBSC1:
+    case kBSC2:
+      zside   = copyno-1;
+      break;
+    case kBSCTrap:
+      det   = 0;
+      station =  2*(copyno-1);
+      break;
+    case kBSCTubs:
+      det   = 1;
+      station =  copyno-1;
+      break;
+    case kBSCTTop:
+      ++station;
+      break;
+    case kBSC2Pad:
+      det   = 2;
+      station =  copyno-1;
+      break;
     }
-    intindex = packBscIndex (zside,det,  station);
-    LogDebug("BscSim") << "BscNumberingScheme : det " << det << " zside " 
-		       << zside << " station " << station 
-		       << " UnitID 0x" << std::hex << intindex << std::dec;
-
-    for (int ich = 0; ich < level; ich++)
-      LogDebug("BscSim") <<" name = " << name[ich] <<" copy = " << copyno[ich];
-    LogDebug("BscSim") << " packed index = 0x" << std::hex << intindex 
-		       << std::dec;
-
-    delete[] copyno;
-    delete[] name;
+    LogDebug("BscSim") << "BscNumberingScheme  " << "level=" << i << " copyno "
+                       << copyno << " tag " << decoder.tag(i);
   }
+  intindex = packBscIndex (zside,det,  station);
+  LogDebug("BscSim") << "BscNumberingScheme : det " << det << " zside " 
+		     << zside << " station " << station 
+		     << " UnitID 0x" << std::hex << intindex << std::dec;
 
-  return intindex;
+  return decoder.store(intindex);
   
 }
 
@@ -12,7 +12,6 @@
 #include "SimG4Core/Notification/interface/G4TrackToParticleID.h"
 #include "SimG4Core/Physics/interface/G4ProcessTypeEnumerator.h"
 
-#include "SimDataFormats/SimHitMaker/interface/TrackingSlaveSD.h"
 #include "SimDataFormats/TrackingHit/interface/UpdatablePSimHit.h"
 
 
@@ -48,18 +47,13 @@
 BscSD::BscSD(std::string name, const DDCompactView & cpv,
 	     const SensitiveDetectorCatalog & clg,
 	     edm::ParameterSet const & p, const SimTrackManager* manager) :
-  SensitiveTkDetector(name, cpv, clg, p), numberingScheme(0), name(name),
-  hcID(-1), theHC(0), theManager(manager), currentHit(0), theTrack(0), 
-  currentPV(0), unitID(0),  previousUnitID(0), preStepPoint(0), 
-  postStepPoint(0), eventno(0){
-    
-  //Add Bsc Sentitive Detector Name
-  collectionName.insert(name);
-    
+  ForwardTkSD<BscSD,BscG4Hit>(name, cpv, clg, p, manager, "BscSim"),
+  numberingScheme(0) {
     
   //Parameters
   edm::ParameterSet m_p = p.getParameter<edm::ParameterSet>("BscSD");
   int verbn = m_p.getUntrackedParameter<int>("Verbosity");
+  storeHitDetails = m_p.getUntrackedParameter<bool>("StoreHitDetails", true);
   //int verbn = 1;
     
   SetVerboseLevel(verbn);
@@ -71,21 +65,6 @@ BscSD::BscSD(std::string name, const DDCompactView & cpv,
     << "*******************************************************";
     
     
-  slave  = new TrackingSlaveSD(name);
-    
-  //
-  // attach detectors (LogicalVolumes)
-  //
-  const std::vector<std::string>& lvNames = clg.logicalNames(name);
-
-  this->Register();
-
-  for (std::vector<std::string>::const_iterator it=lvNames.begin();
-       it !=lvNames.end(); it++) {
-    this->AssignSD(*it);
-    edm::LogInfo("BscSim") << "BscSD : Assigns SD to LV " << (*it);
-  }
-    
   if      (name == "BSCHits") {
     if (verbn > 0) {
       edm::LogInfo("BscSim") << "name = BSCHits and  new BscNumberingSchem";
@@ -102,9 +81,6 @@ BscSD::BscSD(std::string name, const DDCompactView & cpv,
 
 
 BscSD::~BscSD() { 
-  //AZ:
-  if (slave) delete slave; 
-
   if (numberingScheme)
     delete numberingScheme;
 
@@ -114,23 +90,6 @@ double BscSD::getEnergyDeposit(G4Step* aStep) {
   return aStep->GetTotalEnergyDeposit();
 }
 
-void BscSD::Initialize(G4HCofThisEvent * HCE) { 
-#ifdef debug
-  LogDebug("BscSim") << "BscSD : Initialize called for " << name << std::endl;
-#endif
-
-  theHC = new BscG4HitCollection(name, collectionName[0]);
-  if (hcID<0) 
-    hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  HCE->AddHitsCollection(hcID, theHC);
-
-  tsID   = -2;
-  primID = -2;
-
-  ////    slave->Initialize();
-}
-
-
 bool BscSD::ProcessHits(G4Step * aStep, G4TouchableHistory * ) {
 
   if (aStep == NULL) {
@@ -194,9 +153,6 @@ void BscSD::GetStepInfo(G4Step* aStep) {
   Vx = theTrack->GetVertexPosition().x();
   Vy = theTrack->GetVertexPosition().y();
   Vz = theTrack->GetVertexPosition().z();
-  X  = hitPoint.x();
-  Y  = hitPoint.y();
-  Z  = hitPoint.z();
 }
 
 uint32_t BscSD::setDetUnitId(G4Step * aStep) { 
@@ -205,52 +161,6 @@ uint32_t BscSD::setDetUnitId(G4Step * aStep) {
 }
 
 
-G4bool BscSD::HitExists() {
-  if (primaryID<1) {
-    edm::LogWarning("BscSim") << "***** BscSD error: primaryID = " 
-				  << primaryID
-				  << " maybe detector name changed";
-  }
-
-  // Update if in the same detector, time-slice and for same track   
-  //  if (primaryID == primID && tSliceID == tsID && unitID==previousUnitID) {
-  if (tSliceID == tsID && unitID==previousUnitID) {
-    //AZ:
-    UpdateHit();
-    return true;
-  }
-  // Reset entry point for new primary
-  if (primaryID != primID)
-    ResetForNewPrimary();
-   
-  //look in the HitContainer whether a hit with the same primID, unitID,
-  //tSliceID already exists:
-   
-  G4bool found = false;
-
-  //    LogDebug("BscSim") << "BscSD: HCollection=  " << theHC->entries()    <<std::endl;
-  
-  for (int j=0; j<theHC->entries()&&!found; j++) {
-    BscG4Hit* aPreviousHit = (*theHC)[j];
-    if (aPreviousHit->getTrackID()     == primaryID &&
-	aPreviousHit->getTimeSliceID() == tSliceID  &&
-	aPreviousHit->getUnitID()      == unitID       ) {
-      //AZ:
-      currentHit = aPreviousHit;
-      found      = true;
-    }
-  }          
-
-  if (found) {
-    //AZ:
-    UpdateHit();
-    return true;
-  } else {
-    return false;
-  }    
-}
-
-
 void BscSD::ResetForNewPrimary() {
   
   entrancePoint  = SetToLocal(hitPoint);
@@ -260,18 +170,6 @@ void BscSD::ResetForNewPrimary() {
 }
 
 
-void BscSD::StoreHit(BscG4Hit* hit){
-
-  if (primID<0) return;
-  if (hit == 0 ) {
-    edm::LogWarning("BscSim") << "BscSD: hit to be stored is NULL !!";
-    return;
-  }
-
-  theHC->insert( hit );
-}
-
-
 void BscSD::CreateNewHit() {
 
 #ifdef debug
@@ -313,17 +211,15 @@ void BscSD::CreateNewHit() {
 
   currentHit->setEntry(hitPoint);
 
-  currentHit->setEntryLocalP(hitPointLocal);
-  currentHit->setExitLocalP(hitPointLocalExit);
+  if (storeHitDetails) {
+    currentHit->setEntryLocalP(hitPointLocal);
+    currentHit->setExitLocalP(hitPointLocalExit);
 
-  currentHit->setParentId(ParentId);
-  currentHit->setVx(Vx);
-  currentHit->setVy(Vy);
-  currentHit->setVz(Vz);
-
-  currentHit->setX(X);
-  currentHit->setY(Y);
-  currentHit->setZ(Z);
+    currentHit->setParentId(ParentId);
+    currentHit->setVx(Vx);
+    currentHit->setVy(Vy);
+    currentHit->setVz(Vz);
+  }
 
   UpdateHit();
   
@@ -400,31 +296,6 @@ void BscSD::Summarize() {
 }
 
 
-void BscSD::clear() {
-} 
-
-
-void BscSD::DrawAll() {
-} 
-
-
-void BscSD::PrintAll() {
-  LogDebug("BscSim") << "BscSD: Collection " << theHC->GetName() << "\n";
-  theHC->PrintAllHits();
-} 
-
-
-void BscSD::fillHits(edm::PSimHitContainer& c, std::string n) {
-  if (slave->name() == n) c=slave->hits();
-}
-
-void BscSD::update (const BeginOfEvent * i) {
-  LogDebug("BscSim") << " Dispatched BeginOfEvent for " << GetName()
-                       << " !" ;
-   clearHits();
-   eventno = (*i)()->GetEventID();
-}
-
 void BscSD::update(const BeginOfRun *) {
 
   G4ParticleTable * theParticleTable = G4ParticleTable::GetParticleTable();
@@ -435,17 +306,3 @@ void BscSD::update(const BeginOfRun *) {
 
 } 
 
-void BscSD::update (const ::EndOfEvent*) {
-}
-
-void BscSD::clearHits(){
-  //AZ:
-  slave->Initialize();
-}
-
-std::vector<std::string> BscSD::getNames(){
-  std::vector<std::string> temp;
-  temp.push_back(slave->name());
-  return temp;
-}
-
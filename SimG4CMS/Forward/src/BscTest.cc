@@ -37,6 +37,7 @@
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 #include "CLHEP/Units/GlobalPhysicalConstants.h"
 #include <stdio.h>
+#include <mutex>
 //#include <gsl/gsl_fit.h>
 
 
@@ -114,10 +115,21 @@ BscTest::~BscTest() {
 // Histoes:
 //-----------------------------------------------------------------------------
 
-BscAnalysisHistManager::BscAnalysisHistManager(const TString& managername)
+namespace {
+  // sums of the histograms of all managers, written by the last one
+  std::mutex   mergeLock;
+  int          nManagers = 0;
+  TObjArray*   mergedHistArray = 0;
+}
+
+BscAnalysisHistManager::BscAnalysisHistManager(const TString& managername) : fWritten(false)
 {
   // The Constructor
 
+  {
+    std::lock_guard<std::mutex> guard(mergeLock);
+    ++nManagers;
+  }
   fTypeTitle=managername;
   fHistArray = new TObjArray();      // Array to store histos
   fHistNamesArray = new TObjArray(); // Array to store histos's names
@@ -136,6 +148,11 @@ BscAnalysisHistManager::~BscAnalysisHistManager()
 {
   // The Destructor
 
+  if(!fWritten){
+    std::lock_guard<std::mutex> guard(mergeLock);
+    --nManagers;
+  }
+
   if(fHistArray){
     fHistArray->Delete();
     delete fHistArray;
@@ -151,11 +168,29 @@ BscAnalysisHistManager::~BscAnalysisHistManager()
 void BscAnalysisHistManager::BookHistos()
 {
   // at Start: (mm)
-  HistInit("TrackPhi", "Primary Phi",   100,   0.,360. );
-  HistInit("TrackTheta", "Primary Theta",   100,   0.,180. );
-  HistInit("TrackP", "Track XY position Z+ ",  80, -80., 80.,  80, -80., 80. );
-  HistInit("TrackM", "Track XY position Z-",   80, -80., 80.,  80, -80., 80. );
-  HistInit("DetIDs", "Track DetId - vs +",   16, -0.5, 15.5,16, 15.5, 31.5 );
+  fHisto1[kTrackPhi]   = HistInit("TrackPhi", "Primary Phi",   100,   0.,360. );
+  fHisto1[kTrackTheta] = HistInit("TrackTheta", "Primary Theta",   100,   0.,180. );
+  fHisto2[kTrackP]     = HistInit("TrackP", "Track XY position Z+ ",  80, -80., 80.,  80, -80., 80. );
+  fHisto2[kTrackM]     = HistInit("TrackM", "Track XY position Z-",   80, -80., 80.,  80, -80., 80. );
+  fHisto2[kDetIDs]     = HistInit("DetIDs", "Track DetId - vs +",   16, -0.5, 15.5,16, 15.5, 31.5 );
+
+  // filled by BscTest (MeV, mm, degrees)
+  fHisto1[kSumEDep]          = HistInit("SumEDep", "Primary track energy deposit", 100, 0., 1000. );
+  fHisto1[kTrackL]           = HistInit("TrackL", "Primary track length", 100, 0., 12000. );
+  fHisto1[kVtxX]             = HistInit("VtxX", "Primary vertex X", 100, -50., 50. );
+  fHisto1[kVtxY]             = HistInit("VtxY", "Primary vertex Y", 100, -50., 50. );
+  fHisto1[kVtxZ]             = HistInit("VtxZ", "Primary vertex Z", 100, -25000., 25000. );
+  fHisto1[kPrimaryEta]       = HistInit("PrimaryEta", "Primary Eta", 100, -10., 10. );
+  fHisto1[kPrimaryPhigrad]   = HistInit("PrimaryPhigrad", "Primary Phi", 100, 0., 360. );
+  fHisto1[kPrimaryTh]        = HistInit("PrimaryTh", "Primary Theta", 100, 0., 180. );
+  fHisto1[kPrimaryLastpoZ]   = HistInit("PrimaryLastpoZ", "Primary last point Z", 100, -25000., 25000. );
+  fHisto1[kPrimaryLastpoX]   = HistInit("PrimaryLastpoX", "Primary last point X", 100, -200., 200. );
+  fHisto1[kPrimaryLastpoY]   = HistInit("PrimaryLastpoY", "Primary last point Y", 100, -200., 200. );
+  fHisto1[kXLastpoNumofpart] = HistInit("XLastpoNumofpart", "Primary last point X, more than 4 secondaries", 100, -200., 200. );
+  fHisto1[kYLastpoNumofpart] = HistInit("YLastpoNumofpart", "Primary last point Y, more than 4 secondaries", 100, -200., 200. );
+  fHisto1[kzHits]            = HistInit("zHits", "Hit Z", 100, -15000., 15000. );
+  fHisto1[kzHitsTrLoLe]      = HistInit("zHitsTrLoLe", "Hit Z, primary track length above 8300", 100, -15000., 15000. );
+  fHisto1[kzHitsnoMI]        = HistInit("zHitsnoMI", "Hit Z, no MI", 100, -15000., 15000. );
 }
 
 //-----------------------------------------------------------------------------
@@ -163,7 +198,26 @@ void BscAnalysisHistManager::BookHistos()
 void BscAnalysisHistManager::WriteToFile(const TString& fOutputFile,const TString& fRecreateFile)
 {
 
-  //Write to file = fOutputFile
+  //Add the histograms to the sums; the last manager writes them to file = fOutputFile
+
+  std::lock_guard<std::mutex> guard(mergeLock);
+  if (fWritten) return;
+  fWritten = true;
+  if (mergedHistArray == 0) {
+    mergedHistArray = new TObjArray();
+    for (int i = 0; i <= fHistArray->GetLast(); i++) {
+      TH1* h = (TH1*)(fHistArray->At(i)->Clone());
+      h->SetDirectory(0);
+      mergedHistArray->AddLast(h);
+    }
+  } else {
+    for (int i = 0; i <= fHistArray->GetLast(); i++)
+      ((TH1*)(mergedHistArray->At(i)))->Add((TH1*)(fHistArray->At(i)));
+  }
+  if (--nManagers > 0) {
+    std::cout <<" BscAnalysisHistManager: histograms added, "<<nManagers<<" manager(s) left to write "<<fOutputFile<<std::endl;
+    return;
+  }
 
   std::cout <<"================================================================"<<std::endl;
   std::cout <<" Write this Analysis to File "<<fOutputFile<<std::endl;
@@ -171,12 +225,16 @@ void BscAnalysisHistManager::WriteToFile(const TString& fOutputFile,const TStrin
 
   TFile* file = new TFile(fOutputFile, fRecreateFile);
 
-  fHistArray->Write();
+  mergedHistArray->Write();
   file->Close();
+  delete file;
+  mergedHistArray->Delete();
+  delete mergedHistArray;
+  mergedHistArray = 0;
 }
 //-----------------------------------------------------------------------------
 
-void BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup)
+TH1F* BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup)
 {
   // Add histograms and histograms names to the array
 
@@ -185,13 +243,17 @@ void BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t
   strcat(newtitle," (");
   strcat(newtitle,fTypeTitle);
   strcat(newtitle,") ");
-  fHistArray->AddLast((new TH1F(name, newtitle, nbinsx, xlow, xup)));
+  TH1F* h = new TH1F(name, newtitle, nbinsx, xlow, xup);
+  delete [] newtitle;
+  h->SetDirectory(0);
+  fHistArray->AddLast(h);
   fHistNamesArray->AddLast(new TObjString(name));
+  return h;
 
 }
 //-----------------------------------------------------------------------------
 
-void BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup, Int_t nbinsy, Axis_t ylow, Axis_t yup)
+TH2F* BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t nbinsx, Axis_t xlow, Axis_t xup, Int_t nbinsy, Axis_t ylow, Axis_t yup)
 {
   // Add histograms and histograms names to the array
 
@@ -200,8 +262,12 @@ void BscAnalysisHistManager::HistInit(const char* name, const char* title, Int_t
   strcat(newtitle," (");
   strcat(newtitle,fTypeTitle);
   strcat(newtitle,") ");
-  fHistArray->AddLast((new TH2F(name, newtitle, nbinsx, xlow, xup, nbinsy, ylow, yup)));
+  TH2F* h = new TH2F(name, newtitle, nbinsx, xlow, xup, nbinsy, ylow, yup);
+  delete [] newtitle;
+  h->SetDirectory(0);
+  fHistArray->AddLast(h);
   fHistNamesArray->AddLast(new TObjString(name));
+  return h;
 
 }
 //-----------------------------------------------------------------------------
@@ -326,8 +392,8 @@ void BscTest::update(const EndOfTrack * trk) {
   if(itrk == 1) {
     G4double tracklength  = (*trk)()->GetTrackLength();    // Accumulated track length
 
-    TheHistManager->GetHisto("SumEDep")->Fill(SumEnerDeposit);
-    TheHistManager->GetHisto("TrackL")->Fill(tracklength);
+    TheHistManager->GetHisto(BscAnalysisHistManager::kSumEDep)->Fill(SumEnerDeposit);
+    TheHistManager->GetHisto(BscAnalysisHistManager::kTrackL)->Fill(tracklength);
 
     // direction !!!
     G4ThreeVector   vert_mom  = (*trk)()->GetVertexMomentumDirection();
@@ -638,9 +704,9 @@ void BscTest::update(const EndOfEvent * evt) {
       //UserNtuples->fillh01(vx);
       //UserNtuples->fillh02(vy);
       //UserNtuples->fillh03(vz);
-      TheHistManager->GetHisto("VtxX")->Fill(vx);
-      TheHistManager->GetHisto("VtxY")->Fill(vy);
-      TheHistManager->GetHisto("VtxZ")->Fill(vz);
+      TheHistManager->GetHisto(BscAnalysisHistManager::kVtxX)->Fill(vx);
+      TheHistManager->GetHisto(BscAnalysisHistManager::kVtxY)->Fill(vy);
+      TheHistManager->GetHisto(BscAnalysisHistManager::kVtxZ)->Fill(vz);
     }
   }
   // prim.vertex loop end
@@ -676,18 +742,18 @@ void BscTest::update(const EndOfEvent * evt) {
 
     double th     = mom.theta();
     double eta = -log(tan(th/2));
-    TheHistManager->GetHisto("PrimaryEta")->Fill(eta);
-    TheHistManager->GetHisto("PrimaryPhigrad")->Fill(phigrad);
-    TheHistManager->GetHisto("PrimaryTh")->Fill(th*180./pi);
+    TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryEta)->Fill(eta);
+    TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryPhigrad)->Fill(phigrad);
+    TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryTh)->Fill(th*180./pi);
 
-    TheHistManager->GetHisto("PrimaryLastpoZ")->Fill(lastpo.z());
+    TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryLastpoZ)->Fill(lastpo.z());
     if(lastpo.z() <  z4  ) {
-      TheHistManager->GetHisto("PrimaryLastpoX")->Fill(lastpo.x());
-      TheHistManager->GetHisto("PrimaryLastpoY")->Fill(lastpo.y());
+      TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryLastpoX)->Fill(lastpo.x());
+      TheHistManager->GetHisto(BscAnalysisHistManager::kPrimaryLastpoY)->Fill(lastpo.y());
     }
     if(numofpart >  4  ) {
-      TheHistManager->GetHisto("XLastpoNumofpart")->Fill(lastpo.x());
-      TheHistManager->GetHisto("YLastpoNumofpart")->Fill(lastpo.y());
+      TheHistManager->GetHisto(BscAnalysisHistManager::kXLastpoNumofpart)->Fill(lastpo.x());
+      TheHistManager->GetHisto(BscAnalysisHistManager::kYLastpoNumofpart)->Fill(lastpo.y());
     }
 
     // ==========================================================================
@@ -726,8 +792,8 @@ void BscTest::update(const EndOfEvent * evt) {
       BscG4Hit* aHit = (*theCAFI)[j];
       CLHEP::Hep3Vector hitPoint = aHit->getEntry();
       double   zz    = hitPoint.z();
-      TheHistManager->GetHisto("zHits")->Fill(zz);
-      if(tracklength0>8300.) TheHistManager->GetHisto("zHitsTrLoLe")->Fill(zz);
+      TheHistManager->GetHisto(BscAnalysisHistManager::kzHits)->Fill(zz);
+      if(tracklength0>8300.) TheHistManager->GetHisto(BscAnalysisHistManager::kzHitsTrLoLe)->Fill(zz);
     }
     // varia = 0;
     //     if( varia == 0) {
@@ -750,7 +816,7 @@ void BscTest::update(const EndOfEvent * evt) {
 
 	double   zz    = hitPoint.z();
 
-	TheHistManager->GetHisto("zHitsnoMI")->Fill(zz);
+	TheHistManager->GetHisto(BscAnalysisHistManager::kzHitsnoMI)->Fill(zz);
 
 	if (verbosity > 2) {
 	  std::cout << "BscTest:zHits = " << zz << std::endl;
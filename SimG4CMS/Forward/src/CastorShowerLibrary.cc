@@ -18,15 +18,19 @@
 #include "G4PhysicalConstants.hh"
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 
+#include <algorithm>
+
 //#define DebugLog
 
 CastorShowerLibrary::CastorShowerLibrary(std::string & name, edm::ParameterSet const & p) 
                                           : hf(0), evtInfo(0), emBranch(0), hadBranch(0),
+                                            eventInfo(0), showerEvent(0), preload(false), interpolate(false),
                                             nMomBin(0), totEvents(0), evtPerBin(0),
                                             nBinsE(0),nBinsEta(0),nBinsPhi(0),
                                             nEvtPerBinE(0),nEvtPerBinEta(0),nEvtPerBinPhi(0),
                                             SLenergies(),SLetas(),SLphis() {
   
+  initCells();
   initFile(p);
   
 }
@@ -36,6 +40,7 @@ CastorShowerLibrary::CastorShowerLibrary(std::string & name, edm::ParameterSet c
 
 CastorShowerLibrary::~CastorShowerLibrary() {
   if (hf)     hf->Close();
+  delete showerEvent;
 }
 
 
@@ -60,10 +65,16 @@ void CastorShowerLibrary::initFile(edm::ParameterSet const & p) {
   std::string branchEM     = m_CS.getUntrackedParameter<std::string>("BranchEM");
   std::string branchHAD    = m_CS.getUntrackedParameter<std::string>("BranchHAD");
   verbose                  = m_CS.getUntrackedParameter<bool>("Verbosity",false);
+  preload                  = m_CS.getUntrackedParameter<bool>("PreloadLibrary",false);
+  interpolate              = m_CS.getUntrackedParameter<bool>("InterpolateEnergy",false);
 
-  // Open TFile 
   if (pTreeName.find(".") == 0) pTreeName.erase(0,2);
   const char* nTree = pTreeName.c_str();
+
+  // A binary library is mapped into memory and used in place
+  if (mapFile(pTreeName)) return;
+
+  // Open TFile 
   hf                = TFile::Open(nTree);
 
   // Check that TFile has been successfully opened
@@ -102,6 +113,109 @@ void CastorShowerLibrary::initFile(edm::ParameterSet const & p) {
 			       << " has " << hadBranch->GetEntries() 
 			       << " entries";
 
+  // One event object for all the records read
+  showerEvent = new CastorShowerEvent();
+  emBranch->SetAddress(&showerEvent);
+  hadBranch->SetAddress(&showerEvent);
+
+  // Read the whole library once: showers are then served from memory
+  if (preload) {
+    preloadLibrary(emBranch,  library[0]);
+    preloadLibrary(hadBranch, library[1]);
+    for (int k=0; k<2; k++) {
+      records[k] = library[k].records();
+      fillCells(records[k], cells[k]);
+    }
+    edm::LogInfo("CastorShower") << "CastorShowerLibrary: " << records[0].nRecords
+				 << " EM showers with " << library[0].detID.size()
+				 << " hits and " << records[1].nRecords
+				 << " HAD showers with " << library[1].detID.size()
+				 << " hits preloaded ("
+				 << (library[0].bytes()+library[1].bytes())/(1024*1024) << " MB)";
+    hf->Close();
+    delete hf;
+    hf = 0;
+    evtInfo = emBranch = hadBranch = 0;
+  }
+}
+
+//=============================================================================================
+
+bool CastorShowerLibrary::mapFile(const std::string & fileName) {
+
+  if (!CastorShowerLibraryFile::isBinary(fileName)) return false;
+  std::string error;
+  if (!mapped.map(fileName, error)) {
+    edm::LogError("CastorShower") << "CastorShowerLibrary: " << fileName << " " << error;
+    throw cms::Exception("Unknown", "CastorShowerLibrary")
+      << "Mapping of " << fileName << " fails: it " << error << "\n";
+  }
+  preload = true;
+  for (int k=0; k<2; k++) {
+    records[k] = mapped.records(k);
+    fillCells(records[k], cells[k]);
+  }
+  setBinning(mapped.binning());
+  edm::LogInfo("CastorShower") << "CastorShowerLibrary: " << records[0].nRecords
+			       << " EM and " << records[1].nRecords << " HAD showers mapped from "
+			       << fileName << " (" << mapped.size()/(1024*1024) << " MB)";
+  return true;
+}
+
+//=============================================================================================
+
+void CastorShowerLibrary::preloadLibrary(TBranchObject* branch, CastorShowerLibraryFile::Buffer & lib) {
+
+  lib.clear();
+  int nrc = branch->GetEntries();
+  lib.primE.reserve(nrc);
+  lib.primPhi.reserve(nrc);
+  lib.offset.reserve(nrc+1);
+  for (int irc=0; irc<nrc; irc++) {
+    branch->GetEntry(irc);
+    lib.append(*showerEvent);
+  }
+}
+
+//=============================================================================================
+
+void CastorShowerLibrary::initCells() {
+
+  // A rotation by n octants moves the sector field (bits 4-7 of the detId,
+  // cell%16 in the dense index) by 2n sectors: backward at positive z and
+  // forward at negative z (revision 1.9 of CastorNumberingScheme)
+  for (int c=0; c<nCells; c++) {
+    cellID[c] = HcalCastorDetId::detIdFromDenseIndex(c).rawId();
+    int sec   = c%HcalCastorDetId::kNumberSectorsPerEnd;
+    for (int n=0; n<8; n++) {
+      rotated[0][n][c] = c - sec + ((sec+2*n) & 15);
+      rotated[1][n][c] = c - sec + ((sec-2*n) & 15);
+    }
+  }
+}
+
+void CastorShowerLibrary::fillCells(const CastorShowerLibraryFile::Records & lib,
+				    std::vector<uint16_t> & cell) {
+
+  unsigned int nHit = (lib.nRecords > 0) ? lib.offset[lib.nRecords] : 0;
+  cell.resize(nHit);
+  for (unsigned int i=0; i<nHit; i++) {
+    uint32_t c = HcalCastorDetId(lib.detID[i]).denseIndex();
+    bool   ok  = (c < (uint32_t)(nCells) &&
+		  HcalCastorDetId::detIdFromDenseIndex(c).rawId() == lib.detID[i]);
+    cell[i]    = ok ? c : (uint16_t)(noCell);
+  }
+}
+
+int CastorShowerLibrary::octant(double phi) {
+  if (phi < 0) phi += 2*M_PI;
+  return ((int)(phi/(M_PI/4))) & 7;
+}
+
+const uint16_t * CastorShowerLibrary::rotation(double trackPhi, double trackZ,
+					       const Shower & hits) const {
+  int n = (octant(trackPhi) - octant(hits.getPrimPhi())) & 7;
+  return rotated[(trackZ > 0) ? 1 : 0][n];
 }
 
 //=============================================================================================
@@ -121,24 +235,45 @@ void CastorShowerLibrary::loadEventInfo(TBranchObject* branch) {
   branch->GetEntry(0);
   // Initialize shower library general parameters
 
-  totEvents   = eventInfo->Energy.getNEvts();
+  CastorShowerLibraryFile::Binning bin;
+  bin.totEvents     = eventInfo->Energy.getNEvts();
 //  nMomBin     = eventInfo->Energy.getNBins();
 //  evtPerBin   = eventInfo->Energy.getNEvtPerBin();
 //  pmom        = eventInfo->Energy.getBin();
-  nBinsE        = eventInfo->Energy.getNBins();
-  nEvtPerBinE   = eventInfo->Energy.getNEvtPerBin();
-  SLenergies    = eventInfo->Energy.getBin();
-  nBinsEta      = eventInfo->Eta.getNBins();
-  nEvtPerBinEta = eventInfo->Eta.getNEvtPerBin();
-  SLetas        = eventInfo->Eta.getBin();
-  nBinsPhi      = eventInfo->Phi.getNBins();
-  nEvtPerBinPhi = eventInfo->Phi.getNEvtPerBin();
-  SLphis        = eventInfo->Phi.getBin();
+  bin.nBinsE        = eventInfo->Energy.getNBins();
+  bin.nEvtPerBinE   = eventInfo->Energy.getNEvtPerBin();
+  bin.energies      = eventInfo->Energy.getBin();
+  bin.nBinsEta      = eventInfo->Eta.getNBins();
+  bin.nEvtPerBinEta = eventInfo->Eta.getNEvtPerBin();
+  bin.etas          = eventInfo->Eta.getBin();
+  bin.nBinsPhi      = eventInfo->Phi.getNBins();
+  bin.nEvtPerBinPhi = eventInfo->Phi.getNEvtPerBin();
+  bin.phis          = eventInfo->Phi.getBin();
+  setBinning(bin);
+}
+
+//=============================================================================================
+
+void CastorShowerLibrary::setBinning(const CastorShowerLibraryFile::Binning & bin) {
+
+  totEvents     = bin.totEvents;
+  nBinsE        = bin.nBinsE;
+  nEvtPerBinE   = bin.nEvtPerBinE;
+  SLenergies    = bin.energies;
+  nBinsEta      = bin.nBinsEta;
+  nEvtPerBinEta = bin.nEvtPerBinEta;
+  SLetas        = bin.etas;
+  nBinsPhi      = bin.nBinsPhi;
+  nEvtPerBinPhi = bin.nEvtPerBinPhi;
+  SLphis        = bin.phis;
   
   // Convert from GeV to MeV
   for (unsigned int i=0; i<SLenergies.size(); i++) SLenergies[i] *= GeV;
+  energyBins.init(SLenergies);
+  etaBins.init(SLetas);
+  phiBins.init(SLphis);
   
-  edm::LogInfo("CastorShower") << " CastorShowerLibrary::loadEventInfo : " 
+  edm::LogInfo("CastorShower") << " CastorShowerLibrary::setBinning : " 
 			       << "\n \n Total number of events     :  " << totEvents 
 			       <<    "\n   Number of bins  (E)       :  " << nBinsE
 			       <<    "\n   Number of events/bin (E)  :  " << nEvtPerBinE
@@ -209,7 +344,7 @@ void CastorShowerLibrary::initParticleTable(G4ParticleTable * theParticleTable)
 
 //=============================================================================================
 
-CastorShowerEvent CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok) {
+const CastorShowerLibrary::Shower & CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok) {
 
   G4StepPoint * preStepPoint  = aStep->GetPreStepPoint(); 
   // G4StepPoint * postStepPoint = aStep->GetPostStepPoint(); 
@@ -223,14 +358,13 @@ CastorShowerEvent CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok)
   G4String      partType = track->GetDefinition()->GetParticleName();
   int           parCode  = track->GetDefinition()->GetPDGEncoding();
 
-  CastorShowerEvent hit;
-  hit.Clear();
+  shower = Shower();
   
   ok = false;
   if (parCode == pi0PDG   || parCode == etaPDG    || parCode == nuePDG  ||
       parCode == numuPDG  || parCode == nutauPDG  || parCode == anuePDG ||
       parCode == anumuPDG || parCode == anutauPDG || parCode == geantinoPDG) 
-    return hit;
+    return shower;
   ok = true;
 
   double pin    = preStepPoint->GetTotalEnergy();
@@ -245,7 +379,7 @@ CastorShowerEvent CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok)
 
   // Replace "interpolation/extrapolation" by new method "select" that just randomly 
   // selects a record from the appropriate energy bin and fills its content to  
-  // "showerEvent" instance of class CastorShowerEvent
+  // "shower"
   
   if (parCode == emPDG || parCode == epPDG || parCode == gammaPDG ) {
     select(0, pin, etain, phiin);
@@ -263,8 +397,7 @@ CastorShowerEvent CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok)
     // }
   }
     
-  hit = (*showerEvent);
-  return hit;
+  return shower;
 
 }
 
@@ -273,8 +406,8 @@ CastorShowerEvent CastorShowerLibrary::getShowerHits(G4Step * aStep, bool & ok)
 void CastorShowerLibrary::getRecord(int type, int record) {
 //////////////////////////////////////////////////////////////
 //
-//  Retrieve event # "record" from the library and stores it   
-//  into  vector<CastorShowerHit> showerHit;
+//  Retrieve event # "record" from the library and points  
+//  "shower" to its hits
 //
 //  Based on HFShowerLibrary::getRecord
 //
@@ -285,18 +418,34 @@ void CastorShowerLibrary::getRecord(int type, int record) {
 #ifdef DebugLog
   LogDebug("CastorShower") << "CastorShowerLibrary::getRecord: ";
 #endif  
-  int nrc  = record;
-  showerEvent = new CastorShowerEvent();
-  if (type > 0) {
-    hadBranch->SetAddress(&showerEvent);
-    hadBranch->GetEntry(nrc);
-  } else {
-    emBranch->SetAddress(&showerEvent);
-    emBranch->GetEntry(nrc);
+  // Without preloading, the record is read from file into "current"
+  CastorShowerLibraryFile::Records lib = records[(type > 0) ? 1 : 0];
+  shower = Shower();
+  if (!preload) {
+    TBranchObject * branch = (type > 0) ? hadBranch : emBranch;
+    current.clear();
+    if (branch->GetEntry(record) > 0) current.append(*showerEvent);
+    lib    = current.records();
+    fillCells(lib, currentCells);
+    record = (lib.nRecords > 0) ? 0 : -1;
+  }
+
+  if (record < 0 || record >= (int)(lib.nRecords)) {
+    LogDebug("CastorShower") << "CastorShowerLibrary::getRecord: no record of type "
+			     << type << " with this number";
+    return;
   }
+  unsigned int first = lib.offset[record];
+  shower.nHit     = lib.offset[record+1] - first;
+  shower.primE    = lib.primE[record];
+  shower.primPhi  = lib.primPhi[record];
+  shower.detID    = lib.detID + first;
+  shower.cell     = (preload ? cells[(type > 0) ? 1 : 0].data() : currentCells.data()) + first;
+  shower.nPhotons = lib.nPhotons + first;
+  shower.time     = lib.time + first;
 
 #ifdef DebugLog
-  int nHit = showerEvent->getNhit();
+  int nHit = shower.getNhit();
   LogDebug("CastorShower") << "CastorShowerLibrary::getRecord: Record " << record
 		           << " of type " << type << " with " << nHit 
 		           << " CastorShowerHits";
@@ -363,6 +512,14 @@ void CastorShowerLibrary::select(int type, double pin, double etain, double phii
 */
   int ienergy = FindEnergyBin(pin);
   int ieta    = FindEtaBin(etain);
+
+  // Between two energy points of the library, take the upper one with a
+  // probability growing linearly from 0 to 1 (the hits are rescaled to the
+  // track energy afterwards)
+  if (interpolate && ienergy >= 0 && ienergy+1 < (int)(SLenergies.size())) {
+    double w = (pin-SLenergies[ienergy])/(SLenergies[ienergy+1]-SLenergies[ienergy]);
+    if (G4UniformRand() < w) ienergy++;
+  }
 #ifdef DebugLog
   if (verbose) edm::LogInfo("CastorShower") << " ienergy = " << ienergy ;
   if (verbose) edm::LogInfo("CastorShower") << " ieta = " << ieta;
@@ -396,49 +553,63 @@ void CastorShowerLibrary::select(int type, double pin, double etain, double phii
   getRecord (type, irec);
   
 }
-int CastorShowerLibrary::FindEnergyBin(double energy) {
+int CastorShowerLibrary::FindEnergyBin(double energy) const {
   //
   // returns the integer index of the energy bin, taken from SLenergies vector
   // returns -1 if ouside valid range
   //
-  if (energy >= SLenergies.back()) return SLenergies.size()-1;
-
-  unsigned int i = 0;
-  for(;i<SLenergies.size()-1;i++)
-    if (energy >= SLenergies.at(i) && energy < SLenergies.at(i+1)) return (int)i;
-
-  // now i points to the last but 1 bin
-  if (energy>=SLenergies.at(i)) return (int)i;
-  // energy outside bin range
-  return -1;
+  return energyBins.find(energy);
 }
-int CastorShowerLibrary::FindEtaBin(double eta) {
+int CastorShowerLibrary::FindEtaBin(double eta) const {
   //
   // returns the integer index of the eta bin, taken from SLetas vector
   // returns -1 if ouside valid range
   //
-  if (eta>=SLetas.back()) return SLetas.size()-1;
-  unsigned int i = 0;
-  for(;i<SLetas.size()-1;i++)
-     if (eta >= SLetas.at(i) && eta < SLetas.at(i+1)) return (int)i;
-  // now i points to the last but 1 bin
-  if (eta>=SLetas.at(i)) return (int)i;
-  // eta outside bin range
-  return -1;
+  return etaBins.find(eta);
 }
-int CastorShowerLibrary::FindPhiBin(double phi) {
+int CastorShowerLibrary::FindPhiBin(double phi) const {
   //
   // returns the integer index of the phi bin, taken from SLphis vector
   // returns -1 if ouside valid range
   //
-  // needs protection in case phi is outside range -pi,pi
-  //
-  if (phi>=SLphis.back()) return SLphis.size()-1;
-  unsigned int i = 0;
-  for(;i<SLphis.size()-1;i++)
-     if (phi >= SLphis.at(i) && phi < SLphis.at(i+1)) return (int)i;
-  // now i points to the last but 1 bin
-  if (phi>=SLphis.at(i)) return (int)i;
-  // phi outside bin range
-  return -1;
+  return phiBins.find(phi);
+}
+
+//=======================================================================================
+
+void CastorShowerLibrary::BinFinder::init(const std::vector<double> & e) {
+
+  edges = e;
+  cellBin.clear();
+  x0 = invWidth = 0;
+  if (edges.size() < 2) return;
+
+  // The cells must not be wider than the narrowest bin; if that takes too
+  // many of them (or the edges are not increasing), search instead
+  double minWidth = edges.back()-edges.front();
+  for (unsigned int i=1; i<edges.size(); i++) minWidth = std::min(minWidth, edges[i]-edges[i-1]);
+  if (!(minWidth > 0)) return;
+  double range = edges.back()-edges.front();
+  if (range/minWidth >= maxCells) return;
+  int nCell = (int)(range/minWidth) + 1;
+  x0        = edges.front();
+  invWidth  = nCell/range;
+  cellBin.resize(nCell);
+  for (int k=0; k<nCell; k++) {
+    double x = x0 + k/invWidth;
+    cellBin[k] = std::max(0, (int)(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin()) - 1);
+  }
+}
+
+int CastorShowerLibrary::BinFinder::find(double x) const {
+
+  if (edges.empty() || !(x >= edges.front())) return -1;
+  int last = edges.size()-1;
+  if (x >= edges[last]) return last;
+  if (cellBin.empty())
+    return (int)(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin()) - 1;
+  int k = std::min((int)((x-x0)*invWidth), (int)(cellBin.size())-1);
+  int i = cellBin[k];
+  while (i < last && x >= edges[i+1]) i++;
+  return i;
 }
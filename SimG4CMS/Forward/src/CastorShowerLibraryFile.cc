@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: CastorShowerLibraryFile.cc
+// Description: Binary, memory-mappable CASTOR shower library
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/CastorShowerLibraryFile.h"
+#include "SimDataFormats/CaloHit/interface/CastorShowerEvent.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char CastorShowerLibraryFile::fileMagic[8] = {'C','A','S','T','O','R','S','L'};
+
+//=============================================================================================
+
+void CastorShowerLibraryFile::Buffer::clear() {
+  offset.assign(1, 0);
+  primE.clear();
+  primPhi.clear();
+  detID.clear();
+  nPhotons.clear();
+  time.clear();
+}
+
+void CastorShowerLibraryFile::Buffer::append(CastorShowerEvent & evt) {
+  unsigned int nHit = evt.getNhit();
+  for (unsigned int i=0; i<nHit; i++) {
+    detID.push_back(evt.getDetID(i));
+    nPhotons.push_back(evt.getNphotons(i));
+    time.push_back(evt.getTime(i));
+  }
+  offset.push_back(detID.size());
+  primE.push_back(evt.getPrimE());
+  primPhi.push_back(evt.getPrimPhi());
+}
+
+CastorShowerLibraryFile::Records CastorShowerLibraryFile::Buffer::records() const {
+  Records r;
+  r.nRecords = primE.size();
+  r.offset   = offset.data();
+  r.primE    = primE.data();
+  r.primPhi  = primPhi.data();
+  r.detID    = detID.data();
+  r.nPhotons = nPhotons.data();
+  r.time     = time.data();
+  return r;
+}
+
+size_t CastorShowerLibraryFile::Buffer::bytes() const {
+  return recordBytes(primE.size(), detID.size());
+}
+
+//=============================================================================================
+
+CastorShowerLibraryFile::CastorShowerLibraryFile() : mapAddr(0), mapSize(0) {}
+
+CastorShowerLibraryFile::~CastorShowerLibraryFile() {
+  unmap();
+}
+
+void CastorShowerLibraryFile::unmap() {
+  if (mapAddr) munmap(mapAddr, mapSize);
+  mapAddr = 0;
+  mapSize = 0;
+  bin     = Binning();
+  for (int k=0; k<NType; k++) rec[k] = Records();
+}
+
+size_t CastorShowerLibraryFile::recordBytes(uint32_t nRecords, uint32_t nHits) {
+  return (size_t(nRecords)+1)*sizeof(uint32_t) + size_t(nRecords)*2*sizeof(float) +
+    size_t(nHits)*(sizeof(uint32_t)+2*sizeof(float));
+}
+
+bool CastorShowerLibraryFile::isBinary(const std::string & fileName) {
+  std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+  char magic[8];
+  in.read(magic, sizeof(magic));
+  return (in && std::memcmp(magic, fileMagic, sizeof(magic)) == 0);
+}
+
+bool CastorShowerLibraryFile::map(const std::string & fileName, std::string & error) {
+
+  unmap();
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot be opened";
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+    close(fd);
+    error = "is too short";
+    return false;
+  }
+  size_t size = st.st_size;
+  void * addr = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    error = "cannot be mapped";
+    return false;
+  }
+  mapAddr = addr;
+  mapSize = size;
+
+  // Check the header and that the file holds all the arrays it announces
+  const Header * h = static_cast<const Header*>(addr);
+  if (std::memcmp(h->magic, fileMagic, sizeof(fileMagic)) != 0 || h->version != fileVersion) {
+    std::ostringstream os;
+    os << "is not a version " << fileVersion << " binary shower library";
+    error = os.str();
+    unmap();
+    return false;
+  }
+  size_t expected = sizeof(Header) + (size_t(h->nEnergies)+h->nEtas+h->nPhis)*sizeof(double);
+  for (int k=0; k<NType; k++) expected += recordBytes(h->nRecords[k], h->nHits[k]);
+  if (expected != size) {
+    std::ostringstream os;
+    os << "has " << size << " bytes instead of " << expected;
+    error = os.str();
+    unmap();
+    return false;
+  }
+
+  bin.totEvents     = h->totEvents;
+  bin.nBinsE        = h->nBinsE;
+  bin.nEvtPerBinE   = h->nEvtPerBinE;
+  bin.nBinsEta      = h->nBinsEta;
+  bin.nEvtPerBinEta = h->nEvtPerBinEta;
+  bin.nBinsPhi      = h->nBinsPhi;
+  bin.nEvtPerBinPhi = h->nEvtPerBinPhi;
+  const double * d  = reinterpret_cast<const double*>(h+1);
+  bin.energies.assign(d, d+h->nEnergies);  d += h->nEnergies;
+  bin.etas.assign(d, d+h->nEtas);          d += h->nEtas;
+  bin.phis.assign(d, d+h->nPhis);          d += h->nPhis;
+
+  const char * p = reinterpret_cast<const char*>(d);
+  for (int k=0; k<NType; k++) {
+    uint32_t nr = h->nRecords[k], nh = h->nHits[k];
+    rec[k].nRecords = nr;
+    rec[k].offset   = reinterpret_cast<const uint32_t*>(p);  p += (size_t(nr)+1)*sizeof(uint32_t);
+    rec[k].primE    = reinterpret_cast<const float*>(p);     p += nr*sizeof(float);
+    rec[k].primPhi  = reinterpret_cast<const float*>(p);     p += nr*sizeof(float);
+    rec[k].detID    = reinterpret_cast<const uint32_t*>(p);  p += nh*sizeof(uint32_t);
+    rec[k].nPhotons = reinterpret_cast<const float*>(p);     p += nh*sizeof(float);
+    rec[k].time     = reinterpret_cast<const float*>(p);     p += nh*sizeof(float);
+    // the offsets must rise from 0 to nh, so that every record lies
+    // within the hit arrays
+    bool consistent = (rec[k].offset[0] == 0 && rec[k].offset[nr] == nh);
+    for (uint32_t i=1; consistent && i<=nr; i++)
+      if (rec[k].offset[i] < rec[k].offset[i-1]) consistent = false;
+    if (!consistent) {
+      error = "has inconsistent record offsets";
+      unmap();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CastorShowerLibraryFile::write(const std::string & fileName, const Binning & b,
+                                    const Records & em, const Records & had) {
+
+  const Records * r[NType] = {&em, &had};
+  Header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, fileMagic, sizeof(fileMagic));
+  h.version       = fileVersion;
+  h.totEvents     = b.totEvents;
+  h.nBinsE        = b.nBinsE;
+  h.nEvtPerBinE   = b.nEvtPerBinE;
+  h.nBinsEta      = b.nBinsEta;
+  h.nEvtPerBinEta = b.nEvtPerBinEta;
+  h.nBinsPhi      = b.nBinsPhi;
+  h.nEvtPerBinPhi = b.nEvtPerBinPhi;
+  h.nEnergies     = b.energies.size();
+  h.nEtas         = b.etas.size();
+  h.nPhis         = b.phis.size();
+  for (int k=0; k<NType; k++) {
+    h.nRecords[k] = r[k]->nRecords;
+    h.nHits[k]    = (r[k]->nRecords > 0) ? r[k]->offset[r[k]->nRecords] : 0;
+  }
+
+  std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!out) return false;
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  out.write(reinterpret_cast<const char*>(b.energies.data()), b.energies.size()*sizeof(double));
+  out.write(reinterpret_cast<const char*>(b.etas.data()),     b.etas.size()*sizeof(double));
+  out.write(reinterpret_cast<const char*>(b.phis.data()),     b.phis.size()*sizeof(double));
+  for (int k=0; k<NType; k++) {
+    uint32_t nr = h.nRecords[k], nh = h.nHits[k];
+    uint32_t zero = 0;
+    if (nr > 0)
+      out.write(reinterpret_cast<const char*>(r[k]->offset), (size_t(nr)+1)*sizeof(uint32_t));
+    else
+      out.write(reinterpret_cast<const char*>(&zero), sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(r[k]->primE),    nr*sizeof(float));
+    out.write(reinterpret_cast<const char*>(r[k]->primPhi),  nr*sizeof(float));
+    out.write(reinterpret_cast<const char*>(r[k]->detID),    nh*sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(r[k]->nPhotons), nh*sizeof(float));
+    out.write(reinterpret_cast<const char*>(r[k]->time),     nh*sizeof(float));
+  }
+  return !out.fail();
+}
@@ -2,7 +2,6 @@
 #include "SimG4Core/Notification/interface/G4TrackToParticleID.h"
 #include "SimG4Core/Physics/interface/G4ProcessTypeEnumerator.h"
 
-#include "SimDataFormats/SimHitMaker/interface/TrackingSlaveSD.h"
 #include "SimDataFormats/TrackingHit/interface/UpdatablePSimHit.h"
 #include "SimG4CMS/Forward/interface/FastTimerSD.h"
 
@@ -32,18 +31,13 @@ FastTimerSD::FastTimerSD(std::string name, const DDCompactView & cpv,
 			 const SensitiveDetectorCatalog & clg, 
 			 edm::ParameterSet const & p, 
 			 const SimTrackManager* manager) :
-  SensitiveTkDetector(name, cpv, clg, p), ftcons(0), name(name),
-  hcID(-1), theHC(0), theManager(manager), currentHit(0), theTrack(0), 
-  currentPV(0), unitID(0),  previousUnitID(0), preStepPoint(0), 
-  postStepPoint(0), eventno(0){
-    
-  //Add FastTimer Sentitive Detector Name
-  collectionName.insert(name);
-    
+  ForwardTkSD<FastTimerSD,BscG4Hit>(name, cpv, clg, p, manager, "FastTimerSim"),
+  ftcons(0) {
     
   //Parameters
   edm::ParameterSet m_p = p.getParameter<edm::ParameterSet>("FastTimerSD");
   int verbn = m_p.getUntrackedParameter<int>("Verbosity");
+  storeHitDetails = m_p.getUntrackedParameter<bool>("StoreHitDetails", true);
   //int verbn = 1;
     
   SetVerboseLevel(verbn);
@@ -56,21 +50,6 @@ FastTimerSD::FastTimerSD(std::string name, const DDCompactView & cpv,
     << "*******************************************************";
 #endif    
     
-  slave  = new TrackingSlaveSD(name);
-    
-  //
-  // attach detectors (LogicalVolumes)
-  //
-  std::vector<std::string> lvNames = clg.logicalNames(name);
-
-  this->Register();
-
-  for (std::vector<std::string>::iterator it=lvNames.begin();  
-       it !=lvNames.end(); it++) {
-    this->AssignSD(*it);
-    edm::LogInfo("FastTimerSim") << "FastTimerSD : Assigns SD to LV " << (*it);
-  }
-    
   ftcons = new FastTimeDDDConstants(cpv) ;
   type   = ftcons->getType();
   
@@ -80,7 +59,6 @@ FastTimerSD::FastTimerSD(std::string name, const DDCompactView & cpv,
 
 FastTimerSD::~FastTimerSD() { 
 
-  if (slave)  delete slave; 
   if (ftcons) delete ftcons;
 }
 
@@ -88,21 +66,6 @@ double FastTimerSD::getEnergyDeposit(G4Step* aStep) {
   return aStep->GetTotalEnergyDeposit();
 }
 
-void FastTimerSD::Initialize(G4HCofThisEvent * HCE) { 
-#ifdef DebugLog
-  LogDebug("FastTimerSim") << "FastTimerSD : Initialize called for " << name;
-#endif
-
-  theHC = new BscG4HitCollection(name, collectionName[0]);
-  if (hcID<0) 
-    hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  HCE->AddHitsCollection(hcID, theHC);
-
-  tsID   = -2;
-  primID = -2;
-}
-
-
 bool FastTimerSD::ProcessHits(G4Step * aStep, G4TouchableHistory * ) {
 
   if (aStep == NULL) {
@@ -167,9 +130,6 @@ void FastTimerSD::GetStepInfo(G4Step* aStep) {
   Vx = theTrack->GetVertexPosition().x();
   Vy = theTrack->GetVertexPosition().y();
   Vz = theTrack->GetVertexPosition().z();
-  X  = hitPoint.x();
-  Y  = hitPoint.y();
-  Z  = hitPoint.z();
 }
 
 uint32_t FastTimerSD::setDetUnitId(G4Step * aStep) { 
@@ -195,46 +155,6 @@ uint32_t FastTimerSD::setDetUnitId(G4Step * aStep) {
 }
 
 
-G4bool FastTimerSD::HitExists() {
-  if (primaryID<1) {
-    edm::LogWarning("FastTimerSim") << "***** FastTimerSD error: primaryID = " 
-				    << primaryID
-				    << " maybe detector name changed";
-  }
-
-  // Update if in the same detector, time-slice and for same track   
-  if (tSliceID == tsID && unitID==previousUnitID) {
-    UpdateHit();
-    return true;
-  }
-  // Reset entry point for new primary
-  if (primaryID != primID)
-    ResetForNewPrimary();
-   
-  //look in the HitContainer whether a hit with the same primID, unitID,
-  //tSliceID already exists:
-   
-  G4bool found = false;
-
-  for (int j=0; j<theHC->entries()&&!found; j++) {
-    BscG4Hit* aPreviousHit = (*theHC)[j];
-    if (aPreviousHit->getTrackID()     == primaryID &&
-	aPreviousHit->getTimeSliceID() == tSliceID  &&
-	aPreviousHit->getUnitID()      == unitID       ) {
-      currentHit = aPreviousHit;
-      found      = true;
-    }
-  }          
-
-  if (found) {
-    UpdateHit();
-    return true;
-  } else {
-    return false;
-  }    
-}
-
-
 void FastTimerSD::ResetForNewPrimary() {
   
   entrancePoint  = SetToLocal(hitPoint);
@@ -243,17 +163,6 @@ void FastTimerSD::ResetForNewPrimary() {
 }
 
 
-void FastTimerSD::StoreHit(BscG4Hit* hit){
-
-  if (primID<0) return;
-  if (hit == 0) {
-    edm::LogWarning("FastTimerSim") << "FastTimerSD: hit to be stored is NULL !!";
-  } else {
-    theHC->insert( hit );
-  }
-}
-
-
 void FastTimerSD::CreateNewHit() {
 
 #ifdef DebugLog
@@ -295,17 +204,15 @@ void FastTimerSD::CreateNewHit() {
 
   currentHit->setEntry(hitPoint);
 
-  currentHit->setEntryLocalP(hitPointLocal);
-  currentHit->setExitLocalP(hitPointLocalExit);
+  if (storeHitDetails) {
+    currentHit->setEntryLocalP(hitPointLocal);
+    currentHit->setExitLocalP(hitPointLocalExit);
 
-  currentHit->setParentId(ParentId);
-  currentHit->setVx(Vx);
-  currentHit->setVy(Vy);
-  currentHit->setVz(Vz);
-
-  currentHit->setX(X);
-  currentHit->setY(Y);
-  currentHit->setZ(Z);
+    currentHit->setParentId(ParentId);
+    currentHit->setVx(Vx);
+    currentHit->setVy(Vy);
+    currentHit->setVz(Vz);
+  }
 
   UpdateHit();
   
@@ -379,30 +286,6 @@ void FastTimerSD::EndOfEvent(G4HCofThisEvent* ) {
      
 void FastTimerSD::Summarize() {}
 
-void FastTimerSD::clear() {} 
-
-void FastTimerSD::DrawAll() {} 
-
-void FastTimerSD::PrintAll() {
-#ifdef DebugLog
-  edm::LogInfo("FastTimerSim") << "FastTimerSD: Collection "<<theHC->GetName();
-#endif
-  theHC->PrintAllHits();
-} 
-
-void FastTimerSD::fillHits(edm::PSimHitContainer& c, std::string n) {
-  if (slave->name() == n) c=slave->hits();
-}
-
-void FastTimerSD::update (const BeginOfEvent * i) {
-#ifdef DebugLog
-  edm::LogInfo("FastTimerSim") << "Dispatched BeginOfEvent for " << GetName()
-			       << " !" ;
-#endif
-   clearHits();
-   eventno = (*i)()->GetEventID();
-}
-
 void FastTimerSD::update(const BeginOfRun *) {
 
   G4ParticleTable * theParticleTable = G4ParticleTable::GetParticleTable();
@@ -413,14 +296,3 @@ void FastTimerSD::update(const BeginOfRun *) {
 
 } 
 
-void FastTimerSD::update (const ::EndOfEvent*) {}
-
-void FastTimerSD::clearHits(){
-  slave->Initialize();
-}
-
-std::vector<std::string> FastTimerSD::getNames(){
-  std::vector<std::string> temp;
-  temp.push_back(slave->name());
-  return temp;
-}
@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardCaloSummary.cc
+// Description: Per channel summary of the ZDC and CASTOR hits of each event
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ForwardCaloSummary.h"
+#include "SimG4CMS/Forward/interface/ZdcStepRecorder.h"
+#include "SimG4CMS/Calo/interface/CaloG4Hit.h"
+#include "SimG4CMS/Calo/interface/CaloG4HitCollection.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+
+#include <cmath>
+
+enum ntfwdcalo_elements {
+  ntfwdcalo_evt, ntfwdcalo_det, ntfwdcalo_index, ntfwdcalo_npeem, ntfwdcalo_npehad,
+  ntfwdcalo_tmean, ntfwdcalo_trms, ntfwdcalo_nhits
+};
+
+ForwardCaloSummary::ForwardCaloSummary(const edm::ParameterSet &p) :
+  zdcID(-1), castorID(-1), recorder(0), nEvents(0) {
+
+  edm::ParameterSet m_Anal = p.getParameter<edm::ParameterSet>("ForwardCaloSummary");
+  verbosity        = m_Anal.getUntrackedParameter<int>("Verbosity",0);
+  fileName         = m_Anal.getParameter<std::string>("FileName");
+  zdcCollection    = m_Anal.getUntrackedParameter<std::string>("ZdcHitCollection","ZDCHITS");
+  castorCollection = m_Anal.getUntrackedParameter<std::string>("CastorHitCollection","CastorFI");
+
+  Channel empty = {0., 0., 0., 0., 0};
+  for (uint32_t k = 0; k < nZdc+nCastor; ++k) channels[k] = empty;
+  fired.reserve(nZdc+nCastor);
+
+  const char * columns[ntfwdcalo_nhits+1] = {
+    "evt", "det", "index", "npeem", "npehad", "tmean", "trms", "nhits"};
+  recorder = new ZdcStepRecorder(fileName, std::vector<std::string>(columns, columns+ntfwdcalo_nhits+1),
+                                 4096, 2);
+  if (!recorder->good())
+    edm::LogWarning("ForwardSim") << "ForwardCaloSummary: cannot create " << fileName;
+  edm::LogInfo("ForwardSim") << "ForwardCaloSummary: channel sums of " << zdcCollection
+                             << " and " << castorCollection << " written to " << fileName;
+}
+
+ForwardCaloSummary::~ForwardCaloSummary() {
+
+  recorder->close();
+  edm::LogInfo("ForwardSim") << "ForwardCaloSummary: " << recorder->records()
+                             << " channel records of " << nEvents << " events "
+                             << (recorder->good() ? "written to " : "NOT written correctly to ")
+                             << fileName;
+  delete recorder;
+}
+
+void ForwardCaloSummary::update(const BeginOfRun * run) {
+
+  // the collections are known once the sensitive detectors are built
+  G4SDManager * sdm = G4SDManager::GetSDMpointer();
+  zdcID    = sdm->GetCollectionID(zdcCollection);
+  castorID = sdm->GetCollectionID(castorCollection);
+  if (zdcID < 0 && castorID < 0)
+    edm::LogWarning("ForwardSim") << "ForwardCaloSummary: neither " << zdcCollection
+                                  << " nor " << castorCollection << " is in the job";
+}
+
+void ForwardCaloSummary::update(const EndOfEvent * evt) {
+
+  G4HCofThisEvent * allHC = (*evt)()->GetHCofThisEvent();
+  if (allHC != 0) {
+    if (zdcID >= 0)    add(ZDC,    (const CaloG4HitCollection*)(allHC->GetHC(zdcID)));
+    if (castorID >= 0) add(CASTOR, (const CaloG4HitCollection*)(allHC->GetHC(castorID)));
+  }
+  write((*evt)()->GetEventID());
+  ++nEvents;
+}
+
+void ForwardCaloSummary::add(Detector det, const CaloG4HitCollection * hc) {
+
+  if (hc == 0) return;
+  int nentries = hc->entries();
+  for (int ihit = 0; ihit < nentries; ++ihit) {
+    const CaloG4Hit * aHit = (*hc)[ihit];
+    int index = (det == ZDC) ? zdcIndex(aHit->getUnitID()) : castorIndex(aHit->getUnitID());
+    if (index < 0) continue;
+    if (det == CASTOR) index += nZdc;
+    Channel & ch = channels[index];
+    if (ch.nHits == 0) fired.push_back(index);
+    double npe = aHit->getEM()+aHit->getHadr();
+    double t   = aHit->getTimeSlice();
+    ch.em     += aHit->getEM();
+    ch.had    += aHit->getHadr();
+    ch.t      += npe*t;
+    ch.t2     += npe*t*t;
+    ++ch.nHits;
+  }
+}
+
+int ForwardCaloSummary::zdcIndex(uint32_t unitID) {
+
+  HcalZDCDetId id(unitID);
+  int channel = id.channel();
+  int first;
+  switch (id.section()) {
+  case HcalZDCDetId::EM:
+    if (channel < 1 || channel > (int)nZdcEM) return -1;
+    first = 0;
+    break;
+  case HcalZDCDetId::HAD:
+    if (channel < 1 || channel > (int)nZdcHad) return -1;
+    first = nZdcEM;
+    break;
+  case HcalZDCDetId::RPD:
+    if (channel == 0) channel = nZdcRPD;
+    if (channel < 1 || channel > (int)nZdcRPD) return -1;
+    first = nZdcEM+nZdcHad;
+    break;
+  default:
+    return -1;
+  }
+  return (id.zside() > 0 ? nZdcSide : 0) + first + channel-1;
+}
+
+int ForwardCaloSummary::castorIndex(uint32_t unitID) {
+
+  uint32_t index = HcalCastorDetId(unitID).denseIndex();
+  return HcalCastorDetId::validDenseIndex(index) ? (int)index : -1;
+}
+
+void ForwardCaloSummary::write(int evt) {
+
+  float record[ntfwdcalo_nhits+1];
+  record[ntfwdcalo_evt] = (float)evt;
+  double sum[2] = {0., 0.};
+  for (unsigned int k = 0; k < fired.size(); ++k) {
+    uint32_t  index = fired[k];
+    Channel & ch    = channels[index];
+    double    npe   = ch.em+ch.had;
+    double    tmean = (npe > 0.) ? ch.t/npe : 0.;
+    double    tvar  = (npe > 0.) ? ch.t2/npe-tmean*tmean : 0.;
+    bool      zdc   = (index < nZdc);
+    record[ntfwdcalo_det]    = (float)(zdc ? ZDC : CASTOR);
+    record[ntfwdcalo_index]  = (float)(zdc ? index : index-nZdc);
+    record[ntfwdcalo_npeem]  = ch.em;
+    record[ntfwdcalo_npehad] = ch.had;
+    record[ntfwdcalo_tmean]  = tmean;
+    record[ntfwdcalo_trms]   = (tvar > 0.) ? std::sqrt(tvar) : 0.;
+    record[ntfwdcalo_nhits]  = (float)ch.nHits;
+    recorder->fill(record);
+    sum[zdc ? 0 : 1] += npe;
+    ch.em = ch.had = ch.t = ch.t2 = 0.;
+    ch.nHits = 0;
+  }
+
+  if (verbosity > 0)
+    edm::LogInfo("ForwardSim") << "ForwardCaloSummary: event " << evt << " "
+                               << fired.size() << " channels fired, signal "
+                               << sum[0] << " (ZDC) " << sum[1] << " (CASTOR)";
+  fired.clear();
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ForwardTouchableDecoder.cc
+// Description: Cached decoding of touchable paths for forward numbering
+//              schemes
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ForwardTouchableDecoder.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <algorithm>
+
+ForwardTouchableDecoder::ForwardTouchableDecoder(int nLevels, unsigned int cacheSize) :
+  nLevels(nLevels), resolved(false), slot(0) {
+
+  unsigned int size = 1;
+  while (size < cacheSize) size *= 2;
+  cache.resize(size);
+  mask = size-1;
+}
+
+void ForwardTouchableDecoder::addVolume(const std::string & name, int tag) {
+  Volume v = {name, tag, false};
+  names.push_back(v);
+  resolved = false;
+}
+
+void ForwardTouchableDecoder::addEnvelope(const std::string & name, int tag) {
+  Volume v = {name, tag, true};
+  names.push_back(v);
+  resolved = false;
+}
+
+void ForwardTouchableDecoder::resolve() {
+
+  volumes.clear();
+  envelopes.clear();
+  const G4LogicalVolumeStore * lvs = G4LogicalVolumeStore::GetInstance();
+  for (unsigned int k = 0; k < names.size(); ++k) {
+    unsigned int found = 0;
+    for (std::vector<G4LogicalVolume*>::const_iterator it = lvs->begin();
+         it != lvs->end(); ++it) {
+      if ((*it)->GetName() == names[k].name) {
+        volumes.push_back(std::pair<const G4LogicalVolume*,int>(*it, names[k].tag));
+        if (names[k].envelope) envelopes.push_back(*it);
+        ++found;
+      }
+    }
+    LogDebug("ForwardSim") << "ForwardTouchableDecoder: " << found
+                           << " logical volume(s) " << names[k].name
+                           << " for tag " << names[k].tag;
+  }
+  for (unsigned int k = 0; k < cache.size(); ++k) cache[k].used = false;
+  resolved = true;
+}
+
+bool ForwardTouchableDecoder::find(const G4VTouchable * touch, uint32_t & id) {
+
+  if (!resolved) resolve();
+
+  int depth = touch->GetHistoryDepth()+1;
+  int n     = (nLevels > 0 && nLevels < depth) ? nLevels : depth;
+  bool stop = (nLevels <= 0 && !envelopes.empty());
+  path.clear();
+  uint64_t h = 0;
+  for (int i = 0; i < n; ++i) {
+    Level l = {touch->GetVolume(i), touch->GetReplicaNumber(i)};
+    path.push_back(l);
+    h = (h ^ (uint64_t)(uintptr_t)(l.pv) ^ ((uint64_t)(uint32_t)(l.copy) << 40)) * 0x9E3779B97F4A7C15ULL;
+    if (stop && std::find(envelopes.begin(), envelopes.end(),
+                          l.pv->GetLogicalVolume()) != envelopes.end()) break;
+  }
+  h ^= path.size();
+  slot = (unsigned int)(h >> 32) & mask;
+
+  const Slot & s = cache[slot];
+  if (s.used && s.path == path) {
+    id = s.id;
+    return true;
+  }
+  return false;
+}
+
+uint32_t ForwardTouchableDecoder::store(uint32_t id) {
+  Slot & s = cache[slot];
+  s.used = true;
+  s.id   = id;
+  s.path = path;
+  return id;
+}
+
+int ForwardTouchableDecoder::tag(int level) const {
+  const G4LogicalVolume * lv = path[level].pv->GetLogicalVolume();
+  for (unsigned int k = 0; k < volumes.size(); ++k)
+    if (volumes[k].first == lv) return volumes[k].second;
+  return -1;
+}
@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: LibraryHitAccumulator.cc
+// Description: Per shower sums of library deposits by cell and time slice
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/LibraryHitAccumulator.h"
+
+LibraryHitAccumulator::LibraryHitAccumulator(int nCells, double unit) :
+  invUnit(1./unit), head(nCells, -1) {}
+
+void LibraryHitAccumulator::add(int cell, double time, double em, double had, int tag) {
+
+  int slice = (int)(time*invUnit);
+  // a cell has deposits in one or very few slices: follow its chain
+  for (int k = head[cell]; k >= 0; k = next[k]) {
+    if (entry[k].slice == slice) {
+      entry[k].em  += em;
+      entry[k].had += had;
+      return;
+    }
+  }
+  Entry e;
+  e.cell  = cell;
+  e.slice = slice;
+  e.tag   = tag;
+  e.time  = time;
+  e.em    = em;
+  e.had   = had;
+  next.push_back(head[cell]);
+  head[cell] = entry.size();
+  entry.push_back(e);
+}
+
+void LibraryHitAccumulator::clear() {
+  for (unsigned int k = 0; k < entry.size(); ++k) head[entry[k].cell] = -1;
+  next.clear();
+  entry.clear();
+}
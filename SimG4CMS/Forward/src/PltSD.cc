@@ -17,6 +17,7 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include "G4LogicalVolume.hh"
 #include "G4Track.hh"
 #include "G4SDManager.hh"
 #include "G4VProcess.hh"
@@ -38,7 +39,7 @@ PltSD::PltSD(std::string name,
              edm::ParameterSet const & p,
              const SimTrackManager* manager) :
 SensitiveTkDetector(name, cpv, clg, p), myName(name), mySimHit(0),
-oldVolume(0), lastId(0), lastTrack(0), eventno(0) {
+oldVolume(0), lastId(0), currentId(0), lastTrack(0), eventno(0) {
     
     edm::ParameterSet m_TrackerSD = p.getParameter<edm::ParameterSet>("PltSD");
     energyCut           = m_TrackerSD.getParameter<double>("EnergyThresholdForPersistencyInGeV")*GeV; //default must be 0.5 (?)
@@ -61,6 +62,11 @@ oldVolume(0), lastId(0), lastTrack(0), eventno(0) {
     
     theG4ProcessTypeEnumerator = new G4ProcessTypeEnumerator;
     myG4TrackToParticleID = new G4TrackToParticleID;
+
+    for (int plt = 0; plt < 2; ++plt)
+        for (int tel = 0; tel < nTelescopes; ++tel)
+            telescopeIds[plt][tel] = telescopeId(plt, tel);
+    for (int k = 0; k < 3; ++k) checkedLV[k] = 0;
 }
 
 PltSD::~PltSD() {
@@ -104,96 +110,59 @@ uint32_t PltSD::setDetUnitId(G4Step * aStep ) {
     
     unsigned int detId = 0;
     
-    LogDebug("PltSD")<< " DetID = "<<detId;
-    
     //Find number of levels
     const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
     int level = 0;
     if (touch) level = ((touch->GetHistoryDepth())+1);
     
-    //Get name and copy numbers
+    //Get copy numbers
     if ( level > 1 ) {
-        //some debugging with the names
-        G4String sensorName   = touch->GetVolume(2)->GetName();
-        G4String telName      = touch->GetVolume(3)->GetName();
-        G4String volumeName   = touch->GetVolume(4)->GetName();
-        if ( sensorName != "PLTSensorPlane" )
-        std::cout << " PltSD::setDetUnitId -w- Sensor name not PLTSensorPlane " << std::endl;
-        if ( telName != "Telescope" )
-        std::cout << " PltSD::setDetUnitId -w- Telescope name not Telescope " << std::endl;
-        if ( volumeName != "PLT" )
-        std::cout << " PltSD::setDetUnitId -w- Volume name not PLT " << std::endl;
+        checkNames(touch);
         
         //Get the information about which telescope, plane, row/column was hit
         int columnNum = touch->GetReplicaNumber(0);
         int rowNum = touch->GetReplicaNumber(1);
         int sensorNum = touch->GetReplicaNumber(2);
         int telNum  = touch->GetReplicaNumber(3);
-        //temp stores the PLTBCM volume the hit occured in (i.e. was the hit on the + or -z side?)
-        int temp = touch->GetReplicaNumber(5);
-        //convert to the PLT hit id standard
-        int pltNum;
-        if (temp == 2) pltNum = 0;
-        else pltNum = 1;
-
-        //correct the telescope numbers on the -z side to have the same naming convention in phi as the +z side
-        if (pltNum == 0){
-            if (telNum == 0){
-                telNum = 7;
-            }
-            else if (telNum == 1){
-                telNum = 6;
-            }
-            else if (telNum == 2){
-                telNum = 5;
-            }
-            else if (telNum == 3){
-                telNum = 4;
-            }
-            else if (telNum == 4){
-                telNum = 3;
-            }
-            else if (telNum == 5){
-                telNum = 2;
-            }
-            else if (telNum == 6){
-                telNum = 1;
-            }
-            else if (telNum == 7){
-                telNum = 0;
-            }
-        }
-        //the PLT is divided into sets of telescopes on the + and -x sides
-        int halfCarriageNum = -1;
-
-        //If the telescope is on the -x side of the carriage, halfCarriageNum=0.  If on the +x side, it is = 1.
-        if(telNum == 0 || telNum == 1 || telNum == 2 || telNum == 3)
-            halfCarriageNum = 0;
-        else
-            halfCarriageNum = 1;
-        //correct the telescope numbers of the +x half-carriage to range from 0 to 3
-        if(halfCarriageNum == 1){
-            if(telNum == 4){
-                telNum = 0;
-            }
-            else if (telNum == 5){
-                telNum = 1;
-            }
-            else if (telNum == 6){
-                telNum = 2;
-            }
-            else if (telNum == 7){
-                telNum = 3;
-            }
-        }
+        //the PLTBCM volume the hit occured in is copy 2 on the -z side (pltNum 0)
+        int pltNum = (touch->GetReplicaNumber(5) == 2) ? 0 : 1;
+        
+        uint32_t telId = (telNum >= 0 && telNum < nTelescopes) ?
+            telescopeIds[pltNum][telNum] : telescopeId(pltNum, telNum);
         //Define unique detId for each pixel.  See https://twiki.cern.ch/twiki/bin/viewauth/CMS/PLTSimulationGuide for more information
-        detId = 10000000*pltNum+1000000*halfCarriageNum+100000*telNum+10000*sensorNum+100*rowNum+columnNum;
-        //std::cout <<  "Hit Recorded at " << "plt:" << pltNum << " hc:" << halfCarriageNum << " tel:" << telNum << " plane:" << sensorNum << std::endl;
+        detId = telId+10000*sensorNum+100*rowNum+columnNum;
     }
     
+    LogDebug("PltSD")<< " DetID = "<<detId;
     return detId;
 }
 
+uint32_t PltSD::telescopeId(int pltNum, int telNum) {
+    
+    //correct the telescope numbers on the -z side to have the same naming convention in phi as the +z side
+    if (pltNum == 0 && telNum >= 0 && telNum <= 7) telNum = 7-telNum;
+    //the PLT is divided into sets of telescopes on the + and -x sides
+    //If the telescope is on the -x side of the carriage, halfCarriageNum=0.  If on the +x side, it is = 1.
+    int halfCarriageNum = (telNum >= 0 && telNum <= 3) ? 0 : 1;
+    //correct the telescope numbers of the +x half-carriage to range from 0 to 3
+    if (halfCarriageNum == 1 && telNum >= 4 && telNum <= 7) telNum -= 4;
+    return 10000000*pltNum+1000000*halfCarriageNum+100000*telNum;
+}
+
+void PltSD::checkNames(const G4VTouchable* touch) {
+    
+    // names are only compared the first time a logical volume is seen at a level
+    static const char * const expected[3] = {"PLTSensorPlane", "Telescope", "PLT"};
+    for (int k = 0; k < 3; ++k) {
+        const G4VPhysicalVolume * pv = touch->GetVolume(k+2);
+        if (pv->GetLogicalVolume() == checkedLV[k]) continue;
+        if (pv->GetName() != expected[k])
+            edm::LogWarning("PltSD") << "PltSD::setDetUnitId: volume " << pv->GetName()
+                                     << " at level " << k+2 << " is not " << expected[k];
+        checkedLV[k] = pv->GetLogicalVolume();
+    }
+}
+
 void PltSD::EndOfEvent(G4HCofThisEvent *) {
     
     LogDebug("PltSD")<< " Saving the last hit in a ROU " << myName;
@@ -241,7 +210,7 @@ void PltSD::updateHit(G4Step * aStep) {
 bool PltSD::newHit(G4Step * aStep) {
     
     G4Track * theTrack = aStep->GetTrack();
-    uint32_t theDetUnitId = setDetUnitId(aStep);
+    uint32_t theDetUnitId = currentId = setDetUnitId(aStep);
     unsigned int theTrackID = theTrack->GetTrackID();
     
     LogDebug("PltSD") << " OLD (d,t) = (" << lastId << "," << lastTrack
@@ -281,7 +250,7 @@ void PltSD::createHit(G4Step * aStep) {
     float theTof              = aStep->GetPreStepPoint()->GetGlobalTime()/nanosecond;
     float theEnergyLoss       = aStep->GetTotalEnergyDeposit()/GeV;
     int theParticleType       = myG4TrackToParticleID->particleID(theTrack);
-    uint32_t theDetUnitId     = setDetUnitId(aStep);
+    uint32_t theDetUnitId     = currentId; // from newHit for this step
     
     globalEntryPoint = SensitiveDetector::InitialStepPosition(aStep,WorldCoordinates);
     globalExitPoint = SensitiveDetector::FinalStepPosition(aStep,WorldCoordinates);
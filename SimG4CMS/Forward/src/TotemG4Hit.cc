@@ -15,15 +15,15 @@
 // user include files
 #include "SimG4CMS/Forward/interface/TotemG4Hit.h"
 
+G4ThreadLocal G4Allocator<TotemG4Hit>* fpTotemG4HitAllocator = 0;
+
 //
 // constructors and destructor
 //
 
-TotemG4Hit::TotemG4Hit(){
+TotemG4Hit::TotemG4Hit() : theOrigin(0) {
 
   setEntry(0.,0.,0.);
-  theEntryPoint.SetCoordinates(0.,0.,0.);
-  theExitPoint.SetCoordinates(0.,0.,0.);
 
   elem              = 0.;
   hadr              = 0.;
@@ -32,55 +32,24 @@ TotemG4Hit::TotemG4Hit(){
   theUnitID         =  0;
   theTimeSlice      = 0.;
 
-  theX              = 0.;
-  theY              = 0.;
-  theZ              = 0.;
   thePabs           = 0.;
   theTof            = 0.;
   theEnergyLoss     = 0.;
   theParticleType   = 0;
   theThetaAtEntry   = 0.;
   thePhiAtEntry     = 0.;
-  theParentId       = 0;
-  theVx             = 0.;
-  theVy             = 0.;
-  theVz             = 0.;
 }
 
-TotemG4Hit::~TotemG4Hit() {}
-
-TotemG4Hit::TotemG4Hit(const TotemG4Hit &right) {
-
-  entry             = right.entry;
-  elem              = right.elem;
-  hadr              = right.hadr;
-  theIncidentEnergy = right.theIncidentEnergy;
-  theTrackID        = right.theTrackID;
-  theUnitID         = right.theUnitID;
-  theTimeSlice      = right.theTimeSlice;
+TotemG4Hit::~TotemG4Hit() { delete theOrigin; }
 
-  theX              = right.theX;
-  theY              = right.theY;
-  theZ              = right.theZ;
-  thePabs           = right.thePabs;
-  theTof            = right.theTof;
-  theEnergyLoss     = right.theEnergyLoss;
-  theParticleType   = right.theParticleType;
-
-  theThetaAtEntry   = right.theThetaAtEntry;
-  thePhiAtEntry     = right.thePhiAtEntry;
-  theEntryPoint     = right.theEntryPoint;
-  theExitPoint      = right.theExitPoint;
-  theParentId       = right.theParentId;
-  theVx             = right.theVx;
-  theVy             = right.theVy;
-  theVz             = right.theVz;
+TotemG4Hit::TotemG4Hit(const TotemG4Hit &right) : theOrigin(0) {
+  *this = right;
 }
 
-
 const TotemG4Hit& TotemG4Hit::operator=(const TotemG4Hit &right) {
 
-  entry             = right.entry;
+  if (this == &right) return *this;
+  setEntry(right.entry[0], right.entry[1], right.entry[2]);
   elem              = right.elem;
   hadr              = right.hadr;
   theIncidentEnergy = right.theIncidentEnergy;
@@ -88,9 +57,6 @@ const TotemG4Hit& TotemG4Hit::operator=(const TotemG4Hit &right) {
   theUnitID         = right.theUnitID;
   theTimeSlice      = right.theTimeSlice;
  
-  theX              = right.theX;
-  theY              = right.theY;
-  theZ              = right.theZ;
   thePabs           = right.thePabs;
   theTof            = right.theTof ;
   theEnergyLoss     = right.theEnergyLoss   ;
@@ -98,16 +64,22 @@ const TotemG4Hit& TotemG4Hit::operator=(const TotemG4Hit &right) {
 
   theThetaAtEntry   = right.theThetaAtEntry;
   thePhiAtEntry     = right.thePhiAtEntry;
-  theEntryPoint     = right.theEntryPoint;
-  theExitPoint      = right.theExitPoint;
-  theParentId       = right.theParentId;
-  theVx             = right.theVx;
-  theVy             = right.theVy;
-  theVz             = right.theVz;
+
+  if (right.theOrigin) {
+    *origin() = *right.theOrigin;
+  } else {
+    delete theOrigin;
+    theOrigin = 0;
+  }
 
   return *this;
 }
 
+TotemG4Hit::Origin* TotemG4Hit::origin() {
+  if (!theOrigin) theOrigin = new Origin;
+  return theOrigin;
+}
+
 void TotemG4Hit::addEnergyDeposit(const TotemG4Hit& aHit) {
 
   elem += aHit.getEM();
@@ -120,7 +92,7 @@ void TotemG4Hit::Print() {
 }
 
 
-math::XYZPoint TotemG4Hit::getEntry() const           {return entry;}
+math::XYZPoint TotemG4Hit::getEntry() const       {return math::XYZPoint(entry[0],entry[1],entry[2]);}
 
 double     TotemG4Hit::getEM() const              {return elem; }
 void       TotemG4Hit::setEM (double e)           { elem     = e; }
@@ -161,26 +133,26 @@ float      TotemG4Hit::getPhiAtEntry() const      {return thePhiAtEntry;}
 void       TotemG4Hit::setThetaAtEntry(float t)   {theThetaAtEntry = t;}
 void       TotemG4Hit::setPhiAtEntry(float f)     {thePhiAtEntry = f ;}
 
-float      TotemG4Hit::getX() const               {return theX;}
-void       TotemG4Hit::setX(float t)              {theX = t;}
+float      TotemG4Hit::getX() const               {return entry[0];}
+void       TotemG4Hit::setX(float t)              {entry[0] = t;}
 
-float      TotemG4Hit::getY() const               {return theY;}
-void       TotemG4Hit::setY(float t)              {theY = t;}
+float      TotemG4Hit::getY() const               {return entry[1];}
+void       TotemG4Hit::setY(float t)              {entry[1] = t;}
 
-float      TotemG4Hit::getZ() const               {return theZ;}
-void       TotemG4Hit::setZ(float t)              {theZ = t;}
+float      TotemG4Hit::getZ() const               {return entry[2];}
+void       TotemG4Hit::setZ(float t)              {entry[2] = t;}
 
-int        TotemG4Hit::getParentId() const        {return theParentId;}
-void       TotemG4Hit::setParentId(int p)         {theParentId = p;}
+int        TotemG4Hit::getParentId() const        {return theOrigin ? theOrigin->parentId : 0;}
+void       TotemG4Hit::setParentId(int p)         {origin()->parentId = p;}
 
-float      TotemG4Hit::getVx() const              {return theVx;}
-void       TotemG4Hit::setVx(float t)             {theVx = t;}
+float      TotemG4Hit::getVx() const              {return theOrigin ? theOrigin->vx : 0;}
+void       TotemG4Hit::setVx(float t)             {origin()->vx = t;}
 
-float      TotemG4Hit::getVy() const              {return theVy;}
-void       TotemG4Hit::setVy(float t)             {theVy = t;}
+float      TotemG4Hit::getVy() const              {return theOrigin ? theOrigin->vy : 0;}
+void       TotemG4Hit::setVy(float t)             {origin()->vy = t;}
 
-float      TotemG4Hit::getVz() const              {return theVz;}
-void       TotemG4Hit::setVz(float t)             {theVz = t;}
+float      TotemG4Hit::getVz() const              {return theOrigin ? theOrigin->vz : 0;}
+void       TotemG4Hit::setVz(float t)             {origin()->vz = t;}
 
 std::ostream& operator<<(std::ostream& os, const TotemG4Hit& hit) {
   os << " Data of this TotemG4Hit are:\n" 
@@ -14,7 +14,6 @@
 
 // user include files
 #include "SimG4CMS/Forward/interface/TotemRPOrganization.h"
-#include "SimG4CMS/Forward/interface/TotemNumberMerger.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "G4VPhysicalVolume.hh"
@@ -25,9 +24,10 @@
 //
 TotemRPOrganization :: TotemRPOrganization() :
   _needUpdateUnitID(false), _needUpdateData(false), _currentUnitID(-1),
-  _currentPlane(-1), _currentCSC(-1), _currentLayer(-1) {
+  _currentPlane(-1), _currentCSC(-1), _currentLayer(-1), _decoder(6) {
 
   edm::LogInfo("ForwardSim") << "Creating TotemRPOrganization";
+  _decoder.addVolume("myRP", 0);
 }
 
 TotemRPOrganization :: ~TotemRPOrganization() {
@@ -43,27 +43,16 @@ uint32_t TotemRPOrganization :: GetUnitID(const G4Step* aStep) const {
 
 uint32_t TotemRPOrganization :: GetUnitID(const G4Step* aStep) {
 
-  G4VPhysicalVolume* physVol;
-  int32_t UNITA=0;
+  uint32_t UNITA=0;
   const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
-  int ii =0;
-  for( ii = 0; ii < touch->GetHistoryDepth(); ii++ ){
-    physVol = touch->GetVolume(ii);
-   
-#ifdef SCRIVI
-    LogDebug("ForwardSim") << "physVol=" << physVol->GetName() << ", level="
-			   << ii  << ", physVol->GetCopyNo()=" 
-			   << physVol->GetCopyNo();
-#endif
-    if (physVol->GetName() == "myRP") _currentDetectorPosition = 3;
-      
-  }
-  physVol= touch->GetVolume(0);//aStep->GetPreStepPoint()->GetPhysicalVolume();
-  
-  if(physVol->GetName() == "myRP") UNITA=(touch->GetVolume(5)->GetCopyNo())*1111;
+  if (_decoder.find(touch, UNITA)) return UNITA;
+
+  UNITA=0;
+  if (_decoder.tag(0) == 0 && _decoder.levels() > 5)
+    UNITA=(_decoder.copyNo(5))*1111;
 
 #ifdef SCRIVI
   LogDebug("ForwardSim") << "\nUNITA-RP " << UNITA << "\n\n";
 #endif
-  return UNITA;
+  return _decoder.store(UNITA);
 }
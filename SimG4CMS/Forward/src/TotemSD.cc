@@ -22,10 +22,8 @@
 #include "SimG4Core/Physics/interface/G4ProcessTypeEnumerator.h"
  
 #include "SimDataFormats/TrackingHit/interface/UpdatablePSimHit.h"
-#include "SimDataFormats/SimHitMaker/interface/TrackingSlaveSD.h"
 
 #include "SimG4CMS/Forward/interface/TotemSD.h"
-#include "SimG4CMS/Forward/interface/TotemNumberMerger.h"
 #include "SimG4CMS/Forward/interface/TotemT1NumberingScheme.h"
 #include "SimG4CMS/Forward/interface/TotemT2NumberingSchemeGem.h"
 #include "SimG4CMS/Forward/interface/TotemRPNumberingScheme.h"
@@ -48,17 +46,13 @@
 TotemSD::TotemSD(std::string name, const DDCompactView & cpv,
 		 const SensitiveDetectorCatalog & clg,
 		 edm::ParameterSet const & p, const SimTrackManager* manager) :
-  SensitiveTkDetector(name, cpv, clg, p), numberingScheme(0), name(name),
-  hcID(-1), theHC(0), theManager(manager), currentHit(0), theTrack(0), 
-  currentPV(0), unitID(0),  previousUnitID(0), preStepPoint(0), 
-  postStepPoint(0), eventno(0){
-
-  //Add Totem Sentitive Detector Names
-  collectionName.insert(name);
+  ForwardTkSD<TotemSD,TotemG4Hit>(name, cpv, clg, p, manager, "ForwardSim"),
+  numberingScheme(0) {
 
   //Parameters
   edm::ParameterSet m_p = p.getParameter<edm::ParameterSet>("TotemSD");
   int verbn = m_p.getUntrackedParameter<int>("Verbosity");
+  storeHitDetails = m_p.getUntrackedParameter<bool>("StoreHitDetails", true);
  
   SetVerboseLevel(verbn);
   LogDebug("ForwardSim") 
@@ -68,19 +62,6 @@ TotemSD::TotemSD(std::string name, const DDCompactView & cpv,
     << "*                                                     *\n"
     << "*******************************************************";
 
-  slave  = new TrackingSlaveSD(name);
-
-  //
-  // Now attach the right detectors (LogicalVolumes) to me
-  //
-  const std::vector<std::string>& lvNames = clg.logicalNames(name);
-  this->Register();
-  for (std::vector<std::string>::const_iterator it=lvNames.begin();
-       it !=lvNames.end(); it++) {
-    this->AssignSD(*it);
-    edm::LogInfo("ForwardSim") << "TotemSD : Assigns SD to LV " << (*it);
-  }
-
   if      (name == "TotemHitsT1") {
     numberingScheme = dynamic_cast<TotemVDetectorOrganization*>(new TotemT1NumberingScheme(1));
   } else if (name == "TotemHitsT2Si") {
@@ -97,7 +78,6 @@ TotemSD::TotemSD(std::string name, const DDCompactView & cpv,
 } 
 
 TotemSD::~TotemSD() { 
-  if (slave)           delete slave; 
   if (numberingScheme) delete numberingScheme;
 }
 
@@ -125,19 +105,6 @@ uint32_t TotemSD::setDetUnitId(G4Step * aStep) {
   return (numberingScheme == 0 ? 0 : numberingScheme->GetUnitID(aStep));
 }
 
-void TotemSD::Initialize(G4HCofThisEvent * HCE) { 
-
-  LogDebug("ForwardSim") << "TotemSD : Initialize called for " << name;
-
-  theHC = new TotemG4HitCollection(name, collectionName[0]);
-  if (hcID<0) 
-    hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  HCE->AddHitsCollection(hcID, theHC);
-
-  tsID   = -2;
-  primID = -2;
-}
-
 void TotemSD::EndOfEvent(G4HCofThisEvent* ) {
 
   // here we loop over transient hits and make them persistent
@@ -165,35 +132,6 @@ void TotemSD::EndOfEvent(G4HCofThisEvent* ) {
   Summarize();
 }
 
-void TotemSD::clear() {
-} 
-
-void TotemSD::DrawAll() {
-} 
-
-void TotemSD::PrintAll() {
-  LogDebug("ForwardSim") << "TotemSD: Collection " << theHC->GetName();
-  theHC->PrintAllHits();
-} 
-
-void TotemSD::fillHits(edm::PSimHitContainer& c, std::string n) {
-  if (slave->name() == n) c=slave->hits();
-}
-
-void TotemSD::update (const BeginOfEvent * i) {
-  LogDebug("ForwardSim") << " Dispatched BeginOfEvent for " << GetName()
-                       << " !" ;
-   clearHits();
-   eventno = (*i)()->GetEventID();
-}
-
-void TotemSD::update (const ::EndOfEvent*) {
-}
-
-void TotemSD::clearHits(){
-  slave->Initialize();
-}
-
 G4ThreeVector TotemSD::SetToLocal(const G4ThreeVector& global) {
 
   G4ThreeVector       localPoint;
@@ -243,48 +181,6 @@ void TotemSD::GetStepInfo(G4Step* aStep) {
   Vz = theTrack->GetVertexPosition().z();
 }
 
-bool TotemSD::HitExists() {
-   
-  if (primaryID<1) {
-    edm::LogWarning("ForwardSim") << "***** TotemSD error: primaryID = " 
-				  << primaryID
-				  << " maybe detector name changed";
-  }
-   
-  // Update if in the same detector, time-slice and for same track   
-  //  if (primaryID == primID && tSliceID == tsID && unitID==previousUnitID) {
-  if (tSliceID == tsID && unitID==previousUnitID) {
-    UpdateHit();
-    return true;
-  }
-   
-  // Reset entry point for new primary
-  if (primaryID != primID)
-    ResetForNewPrimary();
-   
-  //look in the HitContainer whether a hit with the same primID, unitID,
-  //tSliceID already exists:
-   
-  bool found = false;
-
-  for (int j=0; j<theHC->entries()&&!found; j++) {
-    TotemG4Hit* aPreviousHit = (*theHC)[j];
-    if (aPreviousHit->getTrackID()     == primaryID &&
-	aPreviousHit->getTimeSliceID() == tSliceID  &&
-	aPreviousHit->getUnitID()      == unitID       ) {
-      currentHit = aPreviousHit;
-      found      = true;
-    }
-  }          
-
-  if (found) {
-    UpdateHit();
-    return true;
-  } else {
-    return false;
-  }    
-}
-
 void TotemSD::CreateNewHit() {
 
 #ifdef debug
@@ -328,10 +224,12 @@ void TotemSD::CreateNewHit() {
 
   currentHit->setEntry(Posizio.x(),Posizio.y(),Posizio.z());
 
-  currentHit->setParentId(ParentId);
-  currentHit->setVx(Vx);
-  currentHit->setVy(Vy);
-  currentHit->setVz(Vz);
+  if (storeHitDetails) {
+    currentHit->setParentId(ParentId);
+    currentHit->setVx(Vx);
+    currentHit->setVy(Vy);
+    currentHit->setVz(Vz);
+  }
 
   UpdateHit();
   
@@ -357,10 +255,12 @@ void TotemSD::CreateNewHitEvo() {
 
   //  LogDebug("ForwardSim") << Posizio.x() << " " << Posizio.y() << " " << Posizio.z();
 
-  currentHit->setParentId(ParentId);
-  currentHit->setVx(Vx);
-  currentHit->setVy(Vy);
-  currentHit->setVz(Vz);
+  if (storeHitDetails) {
+    currentHit->setParentId(ParentId);
+    currentHit->setVx(Vx);
+    currentHit->setVy(Vy);
+    currentHit->setVz(Vz);
+  }
 
   G4ThreeVector _PosizioEvo;
   int flagAcc=0;
@@ -505,17 +405,6 @@ void TotemSD::UpdateHit() {
   previousUnitID = unitID;
 }
 
-void TotemSD::StoreHit(TotemG4Hit* hit) {
-
-  if (primID<0) return;
-  if (hit == 0 ) {
-    edm::LogWarning("ForwardSim") << "TotemSD: hit to be stored is NULL !!";
-    return;
-  }
-
-  theHC->insert( hit );
-}
-
 void TotemSD::ResetForNewPrimary() {
   
   entrancePoint  = SetToLocal(hitPoint);
@@ -14,12 +14,15 @@
 
 // user include files
 #include "SimG4CMS/Forward/interface/TotemT1Organization.h"
-#include "SimG4CMS/Forward/interface/TotemNumberMerger.h"
+#include "SimG4CMS/Forward/interface/TotemUnitIDCodec.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "G4VPhysicalVolume.hh"
 #include "G4VTouchable.hh" 
 
+static_assert(TotemT1Organization::MaxObjectTypes == TotemUnitIDCodec::kObjectTypes,
+              "TotemT1 object types do not match the unit ID layout");
+
 //
 // constructors and destructor
 //
@@ -32,6 +35,7 @@ TotemT1Organization :: TotemT1Organization() :  _needUpdateUnitID(false),
 						_currentObjectType(Undefined) {
 
   edm::LogInfo("ForwardSim") << "Creating TotemT1Organization";
+  _decoder.addEnvelope("TotemT1", 0);
 }
 
 TotemT1Organization :: ~TotemT1Organization() {
@@ -48,44 +52,46 @@ uint32_t TotemT1Organization :: GetUnitID(const G4Step* aStep) const {
 
 uint32_t TotemT1Organization :: GetUnitID(const G4Step* aStep) {
 
-  int currLAOT;
   const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
-  G4VPhysicalVolume* physVol;
-  int ii =0;
-  for ( ii = 0; ii < touch->GetHistoryDepth(); ii++ ){
-    physVol = touch->GetVolume(ii);
+  uint32_t unitID;
+  if (_decoder.find(touch, unitID)) {
+    // the data follow from the cached unit ID when asked for
+    _currentUnitID=unitID;
+    _needUpdateData=true;
+    _needUpdateUnitID=false;
+    return unitID;
+  }
 
+  int levels = _decoder.levels();
+  // up to the TotemT1 envelope
+  for (int ii = 0; ii < levels; ii++) {
 #ifdef SCRIVI
-    LogDebug("ForwardSim") << "physVol=" << physVol->GetName()
-			   << ", level=" << ii  << ", physVol->GetCopyNo()=" 
-			   << physVol->GetCopyNo();
+    LogDebug("ForwardSim") << "physVol tag=" << _decoder.tag(ii)
+			   << ", level=" << ii  << ", copy number=" 
+			   << _decoder.copyNo(ii);
 #endif
-
-    if(physVol->GetName() == "TotemT1" && 
-       physVol->GetCopyNo()==1) _currentDetectorPosition = 1;
-    if(physVol->GetName() == "TotemT1" && 
-       physVol->GetCopyNo()==2) _currentDetectorPosition = 2;
+    if (_decoder.tag(ii) == 0) {
+      int copy = _decoder.copyNo(ii);
+      if (copy == 1 || copy == 2) _currentDetectorPosition = copy;
+    }
   }
 
-  touch = aStep->GetPreStepPoint()->GetTouchable();
-  physVol=touch->GetVolume(0);
- 
-  currLAOT=physVol->GetCopyNo();
+  int currLAOT=_decoder.copyNo(0);
   _currentObjectType=static_cast<ObjectType>(currLAOT%MaxObjectTypes);
   _currentLayer=currLAOT/MaxObjectTypes;
   _currentPlane=-1;
   _currentCSC=-1;
 
-  if (touch->GetVolume(1)) {
-    _currentCSC=touch->GetVolume(1)->GetCopyNo();
-    if (touch->GetVolume(2)) _currentPlane=touch->GetVolume(2)->GetCopyNo();
+  if (levels > 1) {
+    _currentCSC=_decoder.copyNo(1);
+    if (levels > 2) _currentPlane=_decoder.copyNo(2);
   }
 #ifdef SCRIVI
   LogDebug("ForwardSim") << "CURRENT CSC "<<_currentCSC << "\n"
 			 << "CURRENT PLANE "<<_currentPlane;
 #endif
   _needUpdateUnitID=true;
-  return GetCurrentUnitID();
+  return _decoder.store(GetCurrentUnitID());
 }
 
 int TotemT1Organization :: GetCurrentUnitID(void) const {
@@ -248,51 +254,20 @@ void TotemT1Organization :: _checkDataUpdate(void) const {
 
 void TotemT1Organization :: _FromUnitIDToData(void) {
 
-  int currDP, currCSC, currOT, currPLA;
-  unsigned long currPL, currLA;
- 
-  // currDP:  0..4 (5)
-  // currPL:  0..infty
-  // currCSC: 0..6 (7)
-  // currLA:  0..infty
-  // currOT:  0..MaxObjectTypes-1 (MaxObjectTypes)
-
-  currDP  = (_currentUnitID/100000) % 5;// 3;
-  currCSC = (_currentUnitID/5)%7;
-  currOT  = (_currentUnitID/(5*7))%MaxObjectTypes;
-  currPLA =  _currentUnitID/(5*7*MaxObjectTypes);
- 
-  TotemNumberMerger splitter;
-  splitter.Split(currPLA,currPL,currLA);
+  TotemUnitIDCodec::T1Fields fields;
+  TotemUnitIDCodec::decode(static_cast<uint32_t>(_currentUnitID), fields);
  
 #ifdef SCRIVI
-  LogDebug("ForwardSim") << "currDP=" << currDP << ", currPL=" << currPL  
-			 << ", currCSC=" << currCSC << ", currLA=" << currLA  
-			 << ", currOT=" << currOT << ", currPLA=" << currPLA  
+  LogDebug("ForwardSim") << "currDP=" << fields.position << ", currPL=" << fields.plane
+			 << ", currCSC=" << fields.csc << ", currLA=" << fields.layer
+			 << ", currOT=" << fields.objectType
 			 << ", _currentUnitID=" << _currentUnitID;
 #endif
-  _currentPlane=currPL-1;
-  _currentCSC=currCSC-1;
-  _currentLayer=currLA-1;
-  _currentObjectType=static_cast<ObjectType>(currOT);
-
-  switch(currDP) {
-  case 0: 
-    _currentDetectorPosition=0;
-    break;
-  case 1: 
-    _currentDetectorPosition=1;
-    break;
-  case 2: 
-    _currentDetectorPosition=2;
-    break;
-  case 3:
-    _currentDetectorPosition=3;
-    break;
-  case 4:
-    _currentDetectorPosition=4;
-    break;
-  } 
+  _currentDetectorPosition=fields.position;
+  _currentPlane=fields.plane-1;
+  _currentCSC=fields.csc-1;
+  _currentLayer=fields.layer-1;
+  _currentObjectType=static_cast<ObjectType>(fields.objectType);
   _needUpdateData=false;
 }
 
@@ -349,20 +324,21 @@ void TotemT1Organization :: _FromDataToUnitID(void) {
  
   currOT=FromObjectTypeToInt(_currentObjectType);
  
-  // currDP:  0..2 (3)
-  // currPL:  0..infty
+  // currDP:  0..4 (5)
+  // currPL:  0..TotemUnitIDCodec::kMaxPlane
   // currCSC: 0..6 (7)
-  // currLA:  0..infty
+  // currLA:  0..TotemUnitIDCodec::kMaxLayer
   // currOT:  0..MaxObjectTypes-1 (MaxObjectTypes)
-
-  TotemNumberMerger merger;
-  int currPLA(merger.Merge(currPL,currLA));
+  if (!TotemUnitIDCodec::fits(currDP,currPL,currCSC,currLA,currOT))
+    edm::LogWarning("ForwardSim") << "TotemT1Organization: plane " << _currentPlane
+				  << " and layer " << _currentLayer
+				  << " overflow the unit ID layout";
  
-  _currentUnitID=currDP*100000+5*(currCSC+7*(currOT+MaxObjectTypes*(currPLA)));
+  _currentUnitID=TotemUnitIDCodec::encode(currDP,currPL,currCSC,currLA,currOT);
 #ifdef SCRIVI
   LogDebug("ForwardSim") << "currDP=" << currDP << ", currPL=" << currPL  
 			 << ", currCSC=" << currCSC << ", currLA=" << currLA  
-			 << ", currOT=" << currOT << ", currPLA=" << currPLA  
+			 << ", currOT=" << currOT
 			 << ", _currentUnitID=" << _currentUnitID;
 #endif
  
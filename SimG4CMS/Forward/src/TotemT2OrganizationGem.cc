@@ -14,12 +14,46 @@
 
 // user include files
 #include "SimG4CMS/Forward/interface/TotemT2OrganizationGem.h"
-#include "SimG4CMS/Forward/interface/TotemNumberMerger.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "G4VPhysicalVolume.hh"
 #include "G4VTouchable.hh" 
 
+namespace {
+  // Unit ID of a leaf volume: offset + copy number at level copyLevel
+  // + 1000 * copy number at level planeLevel (if >= 0)
+  struct T2GemUnit {
+    const char * name;
+    uint32_t     offset;
+    int          copyLevel, planeLevel;
+  };
+  const T2GemUnit t2GemUnits[] = {
+    {"TotemT2gem",                10, 0, -1},
+    {"TotemT2gem_supporto",       20, 0, -1},
+    {"TotemT2gem_detector7r",    100, 0,  2},
+    {"TotemT2gem_HC7r",          200, 1,  3},
+    {"TotemT2gem_drift7r",       300, 1,  3},
+    {"TotemT2gem_driftspace7r",  400, 1,  3},
+    {"TotemT2gem_GEMa7r",        500, 1,  3},
+    {"TotemT2gem_GEMb7r",        600, 1,  3},
+    {"TotemT2gem_GEMc7r",        700, 1,  3},
+    {"TotemT2gem_GAS7r",         800, 1,  3},
+    {"TotemT2gem_GEMa17r",       900, 1,  3},
+    {"TotemT2gem_GEMb17r",      1000, 1,  3},
+    {"TotemT2gem_GEMc17r",      1100, 1,  3},
+    {"TotemT2gem_GAS17r",       1200, 1,  3},
+    {"TotemT2gem_GEMa27r",      1300, 1,  3},
+    {"TotemT2gem_GEMb27r",      1400, 1,  3},
+    {"TotemT2gem_GEMc27r",      1500, 1,  3},
+    {"TotemT2gem_GAS27r",       1600, 1,  3},
+    {"TotemT2gem_strips7r",     1700, 1,  3},
+    {"TotemT2gem_isol7r",       1800, 1,  3},
+    {"TotemT2gem_pads7r",       1900, 1,  3},
+    {"TotemT2gem_HC17r",        2000, 1,  3}
+  };
+  const int nT2GemUnits = sizeof(t2GemUnits)/sizeof(t2GemUnits[0]);
+}
+
 //
 // constructors and destructor
 //
@@ -27,8 +61,9 @@
 TotemT2OrganizationGem :: TotemT2OrganizationGem() :
   _needUpdateUnitID(false), _needUpdateData(false),
   _currentUnitID(-1), _currentPlane(-1), _currentCSC(-1),
-  _currentLayer(-1) {
+  _currentLayer(-1), _decoder(4) {
   edm::LogInfo("ForwardSim") << "Creating TotemT2OrganizationGem";
+  for (int k = 0; k < nT2GemUnits; ++k) _decoder.addVolume(t2GemUnits[k].name, k);
 }
 
 TotemT2OrganizationGem :: ~TotemT2OrganizationGem() {
@@ -40,45 +75,22 @@ uint32_t TotemT2OrganizationGem :: GetUnitID(const G4Step* aStep) const {
 
 uint32_t TotemT2OrganizationGem :: GetUnitID(const G4Step* aStep) {
 
- G4VPhysicalVolume* physVol;
  uint32_t UNITA = 0;
  const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
- int ii =0;
- for( ii = 0; ii < touch->GetHistoryDepth(); ii++ ){
-   physVol = touch->GetVolume(ii);
+ if (_decoder.find(touch, UNITA)) return UNITA;
 
+ UNITA = 0;
+ int k = _decoder.tag(0);
+ if (k >= 0) {
+   const T2GemUnit & unit = t2GemUnits[k];
+   int levels = _decoder.levels();
+   if (unit.copyLevel < levels && unit.planeLevel < levels) {
+     UNITA = unit.offset + _decoder.copyNo(unit.copyLevel);
+     if (unit.planeLevel >= 0) UNITA += (_decoder.copyNo(unit.planeLevel))*1000;
+   }
+ }
 #ifdef SCRIVI
-   LogDebug("ForwardSim") << "physVol=" << physVol->GetName() << ", level=" 
-			  << ii << ", physVol->GetCopyNo()=" 
-			  << physVol->GetCopyNo();
+ LogDebug("ForwardSim") << "UNITA-T2 " << UNITA;
 #endif
-   if (physVol->GetName() == "TotemT2gem") _currentDetectorPosition = 3;
- }
-  
- physVol= touch->GetVolume(0);
-  
- if(physVol->GetName() == "TotemT2gem")UNITA = 10 + physVol->GetCopyNo()  ;
- if(physVol->GetName() == "TotemT2gem_supporto")UNITA =20 +  physVol->GetCopyNo();
- if(physVol->GetName() == "TotemT2gem_detector7r")UNITA = 100 + physVol->GetCopyNo() + (touch->GetVolume(2)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_HC7r")UNITA = 200 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_drift7r")UNITA = 300 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_driftspace7r")UNITA = 400 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMa7r")UNITA = 500 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMb7r")UNITA = 600 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMc7r")UNITA = 700 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GAS7r")UNITA = 800 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMa17r")UNITA = 900 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMb17r")UNITA = 1000 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMc17r")UNITA = 1100 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GAS17r")UNITA = 1200 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMa27r")UNITA = 1300 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMb27r")UNITA = 1400 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GEMc27r")UNITA = 1500 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_GAS27r")UNITA = 1600 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_strips7r")UNITA = 1700 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_isol7r")UNITA = 1800 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_pads7r")UNITA = 1900 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
- if(physVol->GetName() == "TotemT2gem_HC17r")UNITA = 2000 + touch->GetVolume(1)->GetCopyNo()+ (touch->GetVolume(3)->GetCopyNo())*1000;
-
- return UNITA;
+ return _decoder.store(UNITA);
 }
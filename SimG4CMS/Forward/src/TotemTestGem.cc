@@ -35,13 +35,13 @@
 // constructors and destructor
 //
 
-TotemTestGem::TotemTestGem(const edm::ParameterSet &p) {
+TotemTestGem::TotemTestGem(const edm::ParameterSet &p) : evtnum(0) {
   
   edm::ParameterSet m_Anal = p.getParameter<edm::ParameterSet>("TotemTestGem");
   names        = m_Anal.getParameter<std::vector<std::string> >("Names");
  
   edm::LogInfo("ForwardSim") << "TotemTestGem:: Initialised as observer of "
-			     << "begin of job, begin/end events and of G4step";
+			     << "begin of run and begin/end events";
 }
 
 TotemTestGem::~TotemTestGem() {
@@ -53,11 +53,29 @@ TotemTestGem::~TotemTestGem() {
 
 void TotemTestGem::produce(edm::Event& e, const edm::EventSetup&) {
 
-  std::auto_ptr<TotemTestHistoClass> product(new TotemTestHistoClass);
-  fillEvent(*product);
+  if (product.get() == 0) {
+    product.reset(new TotemTestHistoClass);
+    product->setEVT(evtnum);
+  }
   e.put(product);
 }
 
+void TotemTestGem::update(const BeginOfRun * run) {
+
+  // the collections exist once the sensitive detectors are built
+  hcIDs.clear();
+  for (unsigned int in=0; in<names.size(); in++) {
+    int HCid = G4SDManager::GetSDMpointer()->GetCollectionID(names[in]);
+    if (HCid < 0) 
+      edm::LogWarning("ForwardSim") << "TotemTestGem :: no hit collection " 
+				    << names[in];
+    else
+      hcIDs.push_back(HCid);
+    LogDebug("ForwardSim") << "TotemTestGem :: Hit Collection for " <<names[in]
+			   << " of ID " << HCid;
+  }
+}
+
 void TotemTestGem::update(const BeginOfEvent * evt) {
 
   int iev = (*evt)()->GetEventID();
@@ -71,57 +89,38 @@ void TotemTestGem::update(const EndOfEvent * evt) {
   evtnum = (*evt)()->GetEventID();
   LogDebug("ForwardSim") << "TotemTestGem:: Fill event " << evtnum;
 
-  // access to the G4 hit collections 
+  // the hits go straight into the product: the Geant4 collections are
+  // deleted with the event, before produce is called
+  product.reset(new TotemTestHistoClass);
+  product->setEVT(evtnum);
   G4HCofThisEvent* allHC = (*evt)()->GetHCofThisEvent();
+  if (allHC == 0) return;
   
   int nhit = 0;
-  for (unsigned int in=0; in<names.size(); in++) {
-    int HCid = G4SDManager::GetSDMpointer()->GetCollectionID(names[in]);
-    TotemG4HitCollection* theHC = (TotemG4HitCollection*) allHC->GetHC(HCid);
-    LogDebug("ForwardSim") << "TotemTestGem :: Hit Collection for " <<names[in]
-			   << " of ID " << HCid << " is obtained at " << theHC;
-
-    if (HCid >= 0 && theHC > 0) {
-      int nentries = theHC->entries();
-      LogDebug("ForwardSim") << "TotemTestGem :: " << names[in] << " with "
-			     << nentries << " entries";
-      for (int ihit = 0; ihit <nentries; ihit++) {
-	TotemG4Hit* aHit = (*theHC)[ihit];
-	hits.push_back(aHit);
-      }
-      nhit += nentries;
+  for (unsigned int in=0; in<hcIDs.size(); in++) {
+    TotemG4HitCollection* theHC = (TotemG4HitCollection*) allHC->GetHC(hcIDs[in]);
+    if (theHC == 0) continue;
+    int nentries = theHC->entries();
+    LogDebug("ForwardSim") << "TotemTestGem :: collection " << hcIDs[in] 
+			   << " with " << nentries << " entries";
+    for (int ihit = 0; ihit <nentries; ihit++) {
+      const TotemG4Hit* aHit = (*theHC)[ihit];
+      math::XYZPoint entry = aHit->getEntry();
+      product->fillHit(aHit->getUnitID(), aHit->getParticleType(),
+		       aHit->getTrackID(), aHit->getParentId(),
+		       aHit->getEnergyLoss(), aHit->getPabs(), aHit->getVx(),
+		       aHit->getVy(), aHit->getVz(), entry.x(), entry.y(), 
+		       entry.z());
     }
+    nhit += nentries;
   }
  
-  // Writing the data to the Tree
-  LogDebug("ForwardSim") << "TotemTestGem:: --- after fillTree with " << nhit
+  LogDebug("ForwardSim") << "TotemTestGem:: --- product filled with " << nhit
 			 << " Hits";
 }
- 
-void TotemTestGem::fillEvent(TotemTestHistoClass& product) {
-
-  product.setEVT(evtnum);
-  
-  for (unsigned ihit = 0; ihit < hits.size(); ihit++) {
-    TotemG4Hit* aHit = hits[ihit];
-    int UID     = aHit->getUnitID();
-    int Ptype   = aHit->getParticleType();
-    int TID     = aHit->getTrackID();
-    int PID     = aHit->getParentId();
-    float ELoss = aHit->getEnergyLoss();
-    float PABS  = aHit->getPabs();
-    float x     = aHit->getEntry().x();
-    float y     = aHit->getEntry().y();
-    float z     = aHit->getEntry().z();
-    float vx    = aHit->getVx();
-    float vy    = aHit->getVy();
-    float vz    = aHit->getVz();
-    product.fillHit(UID, Ptype, TID, PID, ELoss, PABS, vx, vy, vz, x, y,z);
-  }
-} 
 
 void TotemTestGem::clear() {
 
   evtnum = 0;
-  hits.clear();
+  product.reset();
 }
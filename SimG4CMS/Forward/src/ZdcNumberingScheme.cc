@@ -2,18 +2,45 @@
 // File: ZdcNumberingScheme.cc
 // Date: 02.04
 // Description: Numbering scheme for Zdc
-// Modifications:
+// Modifications: volumes compared by pointer, touchable path cache
 ///////////////////////////////////////////////////////////////////////////////
 #include "SimG4CMS/Forward/interface/ZdcNumberingScheme.h"
 #include "DataFormats/HcalDetId/interface/HcalZDCDetId.h"
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
+#include "G4LogicalVolumeStore.hh"
+#include <algorithm>
 #include <iostream>
 #undef debug
 
-ZdcNumberingScheme::ZdcNumberingScheme(int iv){
+ZdcNumberingScheme::ZdcNumberingScheme(int iv) : lvZDC(0), lvEMLayer(0),
+                                                  lvEMFiber(0), lvRPDPad(0),
+                                                  lvRPDRadiator(0), lvHadLayer(0),
+                                                  lvHadFiber(0) {
     verbosity = iv;
     if (verbosity>0)
         std::cout << "Creating ZDCNumberingScheme" << std::endl;
+    
+    const G4LogicalVolumeStore * lvs = G4LogicalVolumeStore::GetInstance();
+    std::vector<lvp>::const_iterator lvcite;
+    for (lvcite = lvs->begin(); lvcite != lvs->end(); lvcite++) {
+        const G4String & name = (*lvcite)->GetName();
+        if      (name == "ZDC")             lvZDC         = (*lvcite);
+        else if (name == "ZDC_EMLayer")     lvEMLayer     = (*lvcite);
+        else if (name == "ZDC_EMFiber")     lvEMFiber     = (*lvcite);
+        else if (name == "ZDC_RPDPad")      lvRPDPad      = (*lvcite);
+        else if (name == "ZDC_RPDRadiator") lvRPDRadiator = (*lvcite);
+        else if (name == "ZDC_HadLayer")    lvHadLayer    = (*lvcite);
+        else if (name == "ZDC_HadFiber")    lvHadFiber    = (*lvcite);
+    }
+    if (verbosity>0)
+        std::cout << "ZdcNumberingScheme: LogicalVolume pointers " << lvZDC
+        << " for ZDC; " << lvEMLayer << " for ZDC_EMLayer; " << lvEMFiber
+        << " for ZDC_EMFiber; " << lvRPDPad << " for ZDC_RPDPad; "
+        << lvRPDRadiator << " for ZDC_RPDRadiator; " << lvHadLayer
+        << " for ZDC_HadLayer; " << lvHadFiber << " for ZDC_HadFiber"
+        << std::endl;
+    
+    for (int k=0; k<nCache; k++) cache[k].level = 0;
 }
 
 ZdcNumberingScheme::~ZdcNumberingScheme() {
@@ -26,103 +53,119 @@ void ZdcNumberingScheme::setVerbosity(const int iv){ verbosity = iv; }
 
 unsigned int ZdcNumberingScheme::getUnitID(const G4Step* aStep) const {
     
-    uint32_t  index = 0;
-    int level = detectorLevel(aStep);
-    
-    if (level > 0) {
-        int*      copyno = new int[level];
-        G4String* name   = new G4String[level];
-        
-        detectorLevel(aStep, level, copyno, name);
-        
-        int zside   = 0;
-        int channel = 0;
-        int fiber   = 0;
-        int layer   = 0;
-        HcalZDCDetId::Section section = HcalZDCDetId::Unknown;
-        
-        for (int ich=0; ich  <  level; ich++) {
-            if (name[ich] == "ZDC") {
-                if(copyno[ich] == 1)zside = 1;
-                if(copyno[ich] == 2)zside = -1;
-            }
-            else if (name[ich] == "ZDC_EMLayer") {
-                section = HcalZDCDetId::EM;
-                layer = copyno[ich];
-            }
-            else if (name[ich] == "ZDC_EMFiber") {
-                fiber = copyno[ich];
-                if (fiber < 20)
-                    channel = 1;
-                else if (fiber < 39)
-                    channel = 2;
-                else if (fiber < 58)
-                    channel = 3;
-                else if (fiber < 77)
-                    channel = 4;
-                else
-                    channel = 5;
-            }
-            else if (name[ich] == "ZDC_RPDPad") {
-                section = HcalZDCDetId::RPD;
-                layer = copyno[ich];
-                channel = copyno[ich];
-            }
-            else if (name[ich] == "ZDC_RPDRadiator") {
-                fiber = copyno[ich];
-                channel = copyno[ich];
-            }
-            else if (name[ich] == "ZDC_HadLayer") {
-                section = HcalZDCDetId::HAD;
-                layer = copyno[ich];
-                if (layer < 6)
-                    channel = 1;
-                else if (layer < 12)
-                    channel = 2;
-                else if (layer < 18)
-                    channel = 3;
-                else
-                    channel = 4;
-            }
-            else if (name[ich] == "ZDC_HadFiber") {
-                fiber = copyno[ich];
-            }
+    int level, copyno[maxLevel];
+    pvp pvs[maxLevel];
+    detectorLevel(aStep, level, copyno, pvs);
+    if (level <= 0) return 0;
+    
+    // Steps in the same fiber or RPD radiator repeat the same path of
+    // (volume, copy number) inside the ZDC, a few levels deep: look it up
+    // before decoding it
+    uintptr_t hash = level;
+    for (int ich=0; ich < level; ich++)
+        hash = hash*31 + (reinterpret_cast<uintptr_t>(pvs[ich])>>4) + copyno[ich];
+    CacheEntry & entry = cache[(hash ^ (hash>>16)) & (nCache-1)];
+    if (entry.level == level &&
+        std::equal(copyno, copyno+level, entry.copyno) &&
+        std::equal(pvs, pvs+level, entry.pvs))
+        return entry.id;
+    
+    uint32_t index = decode(level, copyno, pvs);
+    entry.level = level;
+    entry.id    = index;
+    std::copy(copyno, copyno+level, entry.copyno);
+    std::copy(pvs, pvs+level, entry.pvs);
+    return index;
+}
+
+uint32_t ZdcNumberingScheme::decode(int level, const int* copyno,
+                                    const pvp* pvs) const {
+    
+    int zside   = 0;
+    int channel = 0;
+    int fiber   = 0;
+    int layer   = 0;
+    HcalZDCDetId::Section section = HcalZDCDetId::Unknown;
+    
+    for (int ich=0; ich  <  level; ich++) {
+        lvp lv = pvs[ich]->GetLogicalVolume();
+        if (lv == lvZDC) {
+            if(copyno[ich] == 1)zside = 1;
+            if(copyno[ich] == 2)zside = -1;
+        }
+        else if (lv == lvEMLayer) {
+            section = HcalZDCDetId::EM;
+            layer = copyno[ich];
+        }
+        else if (lv == lvEMFiber) {
+            fiber = copyno[ich];
+            if (fiber < 20)
+                channel = 1;
+            else if (fiber < 39)
+                channel = 2;
+            else if (fiber < 58)
+                channel = 3;
+            else if (fiber < 77)
+                channel = 4;
+            else
+                channel = 5;
+        }
+        else if (lv == lvRPDPad) {
+            section = HcalZDCDetId::RPD;
+            layer = copyno[ich];
+            channel = copyno[ich];
+        }
+        else if (lv == lvRPDRadiator) {
+            fiber = copyno[ich];
+            channel = copyno[ich];
         }
-        
+        else if (lv == lvHadLayer) {
+            section = HcalZDCDetId::HAD;
+            layer = copyno[ich];
+            if (layer < 6)
+                channel = 1;
+            else if (layer < 12)
+                channel = 2;
+            else if (layer < 18)
+                channel = 3;
+            else
+                channel = 4;
+        }
+        else if (lv == lvHadFiber) {
+            fiber = copyno[ich];
+        }
+    }
+    
 #ifdef debug
-        unsigned intindex=0;
-        // intindex = myPacker.packZdcIndex (section, layer, fiber, channel, zside);
-        intindex = packZdcIndex (section, layer, fiber, channel, zside);
+    unsigned intindex=0;
+    // intindex = myPacker.packZdcIndex (section, layer, fiber, channel, zside);
+    intindex = packZdcIndex (section, layer, fiber, channel, zside);
 #endif
-        
-        bool true_for_positive_eta = true;
-        //if(zside == 1)true_for_positive_eta = true;
-        if(zside == -1)true_for_positive_eta = false;
-        
-        HcalZDCDetId zdcId(section, true_for_positive_eta, channel);
-        index = zdcId.rawId();
-        
+    
+    bool true_for_positive_eta = true;
+    //if(zside == 1)true_for_positive_eta = true;
+    if(zside == -1)true_for_positive_eta = false;
+    
+    HcalZDCDetId zdcId(section, true_for_positive_eta, channel);
+    uint32_t index = zdcId.rawId();
+    
 #ifdef debug
-        std::cout<<"DetectorId: ";
-        std::cout<<zdcId<<std::endl;
-        
-        
-        std::cout<< "ZdcNumberingScheme:"
-        << "  getUnitID - # of levels = "
-        << level << std::endl;
-        for (int ich = 0; ich < level; ich++)
-            std::cout<< "  " << ich  << ": copyno " << copyno[ich]
-            << " name="  << name[ich]
-            << "  section " << section << " zside " << zside
-            << " layer " << layer << " fiber " << fiber
-            << " channel " << channel << "packedIndex ="
-            << intindex << " detId raw: "<<index<<std::endl;
-        
+    std::cout<<"DetectorId: ";
+    std::cout<<zdcId<<std::endl;
+    
+    
+    std::cout<< "ZdcNumberingScheme:"
+    << "  getUnitID - # of levels = "
+    << level << std::endl;
+    for (int ich = 0; ich < level; ich++)
+        std::cout<< "  " << ich  << ": copyno " << copyno[ich]
+        << " name="  << pvs[ich]->GetName()
+        << "  section " << section << " zside " << zside
+        << " layer " << layer << " fiber " << fiber
+        << " channel " << channel << "packedIndex ="
+        << intindex << " detId raw: "<<index<<std::endl;
+    
 #endif
-        
-        delete[] copyno;
-        delete[] name;
-    }
     
     return index;
     
@@ -173,15 +216,19 @@ int ZdcNumberingScheme::detectorLevel(const G4Step* aStep) const {
 }
 
 void ZdcNumberingScheme::detectorLevel(const G4Step* aStep, int& level,
-                                       int* copyno, G4String* name) const {
-    
-    //Get name and copy numbers
-    if (level > 0) {
-        const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
-        for (int ii = 0; ii < level; ii++) {
-            int i      = level - ii - 1;
-            name[ii]   = touch->GetVolume(i)->GetName();
-            copyno[ii] = touch->GetReplicaNumber(i);
-        }
+                                       int* copyno, pvp* pvs) const {
+    
+    //Get volumes and copy numbers from the ZDC envelope down to the leaf:
+    //the levels above it do not enter the ID
+    level = 0;
+    const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
+    if (!touch) return;
+    int depth = touch->GetHistoryDepth()+1;
+    while (level < depth && level < maxLevel) {
+        pvs[level]    = touch->GetVolume(level);
+        copyno[level] = touch->GetReplicaNumber(level);
+        if (pvs[level++]->GetLogicalVolume() == lvZDC) break;
     }
+    std::reverse(pvs, pvs+level);
+    std::reverse(copyno, copyno+level);
 }
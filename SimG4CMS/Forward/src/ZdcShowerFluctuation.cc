@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerFluctuation.cc
+// Description: Batched photon-fluctuation sampler for the ZDC shower library
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ZdcShowerFluctuation.h"
+
+#include "CLHEP/Random/RandomEngine.h"
+#include "Math/ProbFuncMathCore.h"
+#include "Math/QuantFuncMathCore.h"
+
+#include <algorithm>
+
+ZdcShowerFluctuation::ZdcShowerFluctuation() : qGauss(nTable+1), qLandau(nTable+1) {
+
+  // The tails (1% on each side) are evaluated with the quantile functions
+  // themselves; in between the tables are interpolated linearly
+  uLow  = 0.01;
+  uHigh = 0.99;
+  for (int k = 0; k <= nTable; ++k) {
+    double u = std::min(std::max(double(k)/nTable, 0.5*uLow), 1.-0.5*uLow);
+    qGauss[k]  = ROOT::Math::normal_quantile(u, 1.);
+    qLandau[k] = ROOT::Math::landau_quantile(u, 1.);
+  }
+}
+
+ZdcShowerFluctuation::~ZdcShowerFluctuation() {}
+
+void ZdcShowerFluctuation::shoot(CLHEP::HepRandomEngine* engine, int edis, double eav,
+                                 double esig, int n, const float* fact, int* nphot) {
+
+  int dist = (edis == Landau) ? Landau : Gauss;
+  int cap  = int(eav + 5.*esig);
+  // the truncation point only depends on the channel response, which takes
+  // few distinct values: keep the last one
+  double lastFact = -1., umax = 1.;
+  for (int i0 = 0; i0 < n; i0 += nMax) {
+    int nb = std::min(n-i0, int(nMax));
+    engine->flatArray(nb, uniform);
+    for (int i = 0; i < nb; ++i) {
+      double fc = fact[i0+i];
+      int    np = 0;
+      if (fc > 0. && cap >= 0) {
+        // largest fluctuation which keeps fact*photons within the limit
+        if (fc != lastFact) {
+          umax     = (esig > 0.) ? cdf(dist, ((cap+1)/fc - eav)/esig) : 1.;
+          lastFact = fc;
+        }
+        double x    = (esig > 0.) ? quantile(dist, uniform[i]*umax) : 0.;
+        int    nraw = int(eav + esig*x);
+        if (nraw < 0) nraw = 0;
+        np = std::min(int(fc*nraw), cap);
+      }
+      nphot[i0+i] = np;
+    }
+  }
+}
+
+double ZdcShowerFluctuation::cdf(int dist, double x) const {
+  return (dist == Landau) ? ROOT::Math::landau_cdf(x, 1.) : ROOT::Math::normal_cdf(x, 1.);
+}
+
+double ZdcShowerFluctuation::quantile(int dist, double u) const {
+  if (u < uLow || u > uHigh) {
+    if (u <= 0.) u = 1.e-12;
+    return (dist == Landau) ? ROOT::Math::landau_quantile(u, 1.) :
+      ROOT::Math::normal_quantile(u, 1.);
+  }
+  const std::vector<float> & q = (dist == Landau) ? qLandau : qGauss;
+  double t = u*nTable;
+  int    k = int(t);
+  double f = t - k;
+  return q[k] + f*(q[k+1]-q[k]);
+}
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerLUT.cc
+// Description: Lookup table of the ZDC shower parametrization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ZdcShowerLUT.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+  // layout of the binary file:
+  //   char[8] magic, uint32 version, uint32 nClass, nE, nX, nY,
+  //   double logEMin, logEMax, xMin, xMax, yMin, yMax, double eDist[nClass],
+  //   float  tabE[nClass][nE][2], float tabXY[nClass][nX][nY][2]
+  // all in native byte order
+  const char         lutMagic[8] = {'Z','D','C','L','U','T','\0','\0'};
+  const unsigned int lutVersion  = 1;
+
+  // default grid: 0.1 GeV - 10 TeV in log(E), 1 mm steps in x and y
+  const unsigned int defNE = 512, defNX = 121, defNY = 141;
+  const double       defEMin = 0.1, defEMax = 10000.;
+  const double       defXMin = -6.0, defXMax = 6.0;
+  const double       defYMin = -7.0, defYMax = 7.0;
+}
+
+ZdcShowerLUT::ZdcShowerLUT() : filled(false), nE(0), nX(0), nY(0),
+                               logEMin(0), logEMax(0), xMin(0), xMax(0),
+                               yMin(0), yMax(0), invStepE(0), invStepX(0),
+                               invStepY(0) {}
+
+ZdcShowerLUT::~ZdcShowerLUT() {}
+
+void ZdcShowerLUT::resize() {
+  invStepE = (nE > 1) ? (nE-1)/(logEMax-logEMin) : 0.;
+  invStepX = (nX > 1) ? (nX-1)/(xMax-xMin) : 0.;
+  invStepY = (nY > 1) ? (nY-1)/(yMax-yMin) : 0.;
+  eDist.assign(NClass, 0.);
+  tabE.assign(2*NClass*nE, 0.f);
+  tabXY.assign(2*NClass*nX*nY, 0.f);
+}
+
+void ZdcShowerLUT::fill() {
+  nE = defNE; nX = defNX; nY = defNY;
+  logEMin = std::log(defEMin); logEMax = std::log(defEMax);
+  xMin = defXMin; xMax = defXMax;
+  yMin = defYMin; yMax = defYMax;
+  resize();
+
+  for (int ic = 0; ic < NClass; ++ic) {
+    eDist[ic] = (ic == EM) ? 1.0 : 3.0;
+    for (unsigned int ie = 0; ie < nE; ++ie) {
+      double fav, fsig;
+      energyFactors(ic, std::exp(logEMin + ie/invStepE), fav, fsig);
+      tabE[2*(ic*nE+ie)]   = fav;
+      tabE[2*(ic*nE+ie)+1] = fsig;
+    }
+    for (unsigned int ix = 0; ix < nX; ++ix) {
+      for (unsigned int iy = 0; iy < nY; ++iy) {
+        double fav, fsig;
+        positionFactors(xMin + ix/invStepX, yMin + iy/invStepY, fav, fsig);
+        unsigned int k = 2*((ic*nX+ix)*nY+iy);
+        tabXY[k]   = fav;
+        tabXY[k+1] = fsig;
+      }
+    }
+  }
+  filled = true;
+}
+
+bool ZdcShowerLUT::load(const std::string & fileName) {
+  std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!in) return false;
+
+  char         magic[8];
+  unsigned int head[5];
+  double       range[6];
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(head), sizeof(head));
+  in.read(reinterpret_cast<char*>(range), sizeof(range));
+  if (!in || std::memcmp(magic, lutMagic, sizeof(magic)) != 0 ||
+      head[0] != lutVersion || head[1] != (unsigned int)(NClass) ||
+      head[2] < 2 || head[3] < 2 || head[4] < 2) return false;
+
+  nE = head[2]; nX = head[3]; nY = head[4];
+  logEMin = range[0]; logEMax = range[1];
+  xMin    = range[2]; xMax    = range[3];
+  yMin    = range[4]; yMax    = range[5];
+  resize();
+  in.read(reinterpret_cast<char*>(&eDist[0]), eDist.size()*sizeof(double));
+  in.read(reinterpret_cast<char*>(&tabE[0]),  tabE.size()*sizeof(float));
+  in.read(reinterpret_cast<char*>(&tabXY[0]), tabXY.size()*sizeof(float));
+  filled = !in.fail();
+  return filled;
+}
+
+bool ZdcShowerLUT::write(const std::string & fileName) const {
+  if (!filled) return false;
+  std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!out) return false;
+
+  unsigned int head[5]  = {lutVersion, (unsigned int)(NClass), nE, nX, nY};
+  double       range[6] = {logEMin, logEMax, xMin, xMax, yMin, yMax};
+  out.write(lutMagic, sizeof(lutMagic));
+  out.write(reinterpret_cast<const char*>(head), sizeof(head));
+  out.write(reinterpret_cast<const char*>(range), sizeof(range));
+  out.write(reinterpret_cast<const char*>(&eDist[0]), eDist.size()*sizeof(double));
+  out.write(reinterpret_cast<const char*>(&tabE[0]),  tabE.size()*sizeof(float));
+  out.write(reinterpret_cast<const char*>(&tabXY[0]), tabXY.size()*sizeof(float));
+  return !out.fail();
+}
+
+void ZdcShowerLUT::getParameters(int iclass, double energy, double xin, double yin,
+                                 double & eav, double & esig, double & edis) const {
+  int ic = (iclass == EM) ? EM : HAD;
+  if (!filled) {
+    parametrization(ic, energy, xin, yin, eav, esig, edis);
+    return;
+  }
+  edis = eDist[ic];
+
+  double eavE, esigE;
+  double u = (energy > 0.) ? (std::log(energy)-logEMin)*invStepE : -1.;
+  if (u >= 0. && u < nE-1) {
+    unsigned int ie = (unsigned int)(u);
+    double       f  = u - ie;
+    const float* t  = &tabE[2*(ic*nE+ie)];
+    eavE  = t[0] + f*(t[2]-t[0]);
+    esigE = t[1] + f*(t[3]-t[1]);
+  } else {
+    energyFactors(ic, energy, eavE, esigE);
+  }
+
+  double eavXY, esigXY;
+  double ux = (xin-xMin)*invStepX;
+  double uy = (yin-yMin)*invStepY;
+  if (ux >= 0. && ux < nX-1 && uy >= 0. && uy < nY-1) {
+    unsigned int ix  = (unsigned int)(ux);
+    unsigned int iy  = (unsigned int)(uy);
+    double       fx  = ux - ix;
+    double       fy  = uy - iy;
+    const float* t0  = &tabXY[2*((ic*nX+ix)*nY+iy)];
+    const float* t1  = t0 + 2*nY;
+    eavXY  = (1.-fx)*((1.-fy)*t0[0] + fy*t0[2]) + fx*((1.-fy)*t1[0] + fy*t1[2]);
+    esigXY = (1.-fx)*((1.-fy)*t0[1] + fy*t0[3]) + fx*((1.-fy)*t1[1] + fy*t1[3]);
+  } else {
+    positionFactors(xin, yin, eavXY, esigXY);
+  }
+
+  eav  = eavXY*eavE;
+  esig = esigXY*esigE;
+}
+
+void ZdcShowerLUT::parametrization(int iclass, double energy, double xin, double yin,
+                                   double & eav, double & esig, double & edis) {
+  double eavE, esigE, eavXY, esigXY;
+  energyFactors(iclass, energy, eavE, esigE);
+  positionFactors(xin, yin, eavXY, esigXY);
+  eav  = eavXY*eavE;
+  esig = esigXY*esigE;
+  edis = (iclass == EM) ? 1.0 : 3.0;
+}
+
+void ZdcShowerLUT::energyFactors(int iclass, double energy, double & fav, double & fsig) {
+  if (iclass == EM) {
+    fav  = 300.0*std::pow((energy/300.0),0.99);
+    fsig = 30.0*std::pow((energy/300.0),0.54);
+  } else {
+    fav  = 300.0*std::pow((energy/300.0),1.12);
+    fsig = 54.0*std::pow((energy/300.0),0.93);
+  }
+}
+
+void ZdcShowerLUT::positionFactors(double xin, double yin, double & fav, double & fsig) {
+  fav  = ((((((-0.0002*xin-2.0e-13)*xin+0.0022)*xin+1.0e-11)*xin-0.0217)*xin-3.0e-10)*xin+1.0028)*
+    (((0.0001*yin + 0.0056)*yin + 0.0508)*yin + 1.0);
+  fsig = ((((((0.0005*xin - 1.0e-12)*xin - 0.0052)*xin + 5.0e-11)*xin + 0.032)*xin -
+           2.0e-10)*xin + 1.0)*(((0.0006*yin + 0.0071)*yin - 0.031)*yin + 1.0);
+}
@@ -9,6 +9,7 @@
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/RandomNumberGenerator.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
 
 #include "G4VPhysicalVolume.hh"
 #include "G4Step.hh"
@@ -16,15 +17,76 @@
 #include "Randomize.hh"
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 
+#include "TFile.h"
+#include "TTree.h"
+#include "TVectorD.h"
+
+#include <algorithm>
+
 ZdcShowerLibrary::ZdcShowerLibrary(std::string & name, const DDCompactView & cpv,
                                    edm::ParameterSet const & p) {
     edm::ParameterSet m_HS   = p.getParameter<edm::ParameterSet>("ZdcShowerLibrary");
     verbose                  = m_HS.getUntrackedParameter<int>("Verbosity",0);
+    lutFile                  = m_HS.getUntrackedParameter<std::string>("LutFile","");
+    libFile                  = m_HS.getUntrackedParameter<std::string>("LibraryFile","");
+    // share of the parametrized hadronic signal seen by each RPD pad; the
+    // same as for each EM channel until it is measured
+    rpdHadResponse           = m_HS.getUntrackedParameter<double>("RPDHadronResponse",0.18);
+    for (int i = 0; i < ZdcShowerLUT::NClass; i++) paramScale[i] = 1.;
     
-    //  npe = 9; // number of channels or fibers where the energy will be deposited
-    npe = 25;
-    hits.reserve(npe);
+    // Table of the channels where the energy will be deposited: for each
+    // channel the hit is placed at the centre of the channel
+    float xWidthEM = fabs(theXChannelBoundaries[0] - theXChannelBoundaries[1]);
+    float zWidthEM = fabs(theZSectionBoundaries[0] - theZSectionBoundaries[1]);
+    float zWidthHAD = fabs(theZHadChannelBoundaries[0] - theZHadChannelBoundaries[1]);
+    float xWidthRPD = fabs(theXrpdChannelBoundaries[0] - theXrpdChannelBoundaries[1]);
+    float yWidthRPD = fabs(theYrpdChannelBoundaries[0] - theYrpdChannelBoundaries[1]);
+    float zWidthRPD = fabs(theZSectionBoundaries[1]-theZSectionBoundaries[2]);
+    const int nXrpd = sizeof(theXrpdChannelBoundaries)/sizeof(double);
     
+    for (int iside = 0; iside < 2; iside++) {
+        bool side = (iside == 1);
+        for (int i = 0; i < nChannels; i++) {
+            HcalZDCDetId::Section section;
+            int channel;
+            double xx,yy,zz;
+            double xxlocal, yylocal, zzlocal;
+            if (i < nEMChannels) {
+                section = HcalZDCDetId::EM;
+                channel = i+1;
+                xxlocal = theXChannelBoundaries[i]+(xWidthEM/2.);
+                xx = xxlocal + X0;
+                yy = 0.0;
+                yylocal = yy + Y0;
+                zzlocal = theZSectionBoundaries[0]+(zWidthEM/2.);
+                zz = side ? zzlocal + Z0 : zzlocal - Z0;
+            } else if (i < nEMChannels+nHADChannels) {
+                section = HcalZDCDetId::HAD;
+                channel = i-nEMChannels+1;
+                xxlocal = 0.0;
+                xx = xxlocal + X0;
+                yylocal = 0;
+                yy = yylocal + Y0;
+                zzlocal = side ? theZHadChannelBoundaries[channel-1] + (zWidthHAD/2.) :
+                    theZHadChannelBoundaries[channel-1] - (zWidthHAD/2.);
+                zz = side ? zzlocal +  Z0 : zzlocal -  Z0;
+            } else {
+                section = HcalZDCDetId::RPD;
+                channel = i-nEMChannels-nHADChannels+1;
+                xxlocal = theXrpdChannelBoundaries[(channel-1)%nXrpd]+(xWidthRPD/2.);
+                xx = xxlocal + X0;
+                yylocal = theYrpdChannelBoundaries[(channel-1)/nXrpd]+(yWidthRPD/2.);
+                yy = yylocal + Y0;
+                zzlocal = theZSectionBoundaries[0]+(zWidthRPD/2.);
+                zz = side ? zzlocal + Z0 : zzlocal - Z0;
+            }
+            chSection[i]           = section;
+            chNumber[i]            = channel;
+            chPosition[iside][i]   = G4ThreeVector(xx,yy,zz);
+            chEntryLocal[iside][i] = G4ThreeVector(xxlocal,yylocal,zzlocal);
+            chDetID[iside][i]      = HcalZDCDetId(section,side,channel).rawId();
+        }
+    }
 }
 
 ZdcShowerLibrary::~ZdcShowerLibrary() {
@@ -52,169 +114,313 @@ void ZdcShowerLibrary::initRun(G4ParticleTable *theParticleTable){
                          << nutauPDG << ", anti_nu_e = " << anuePDG
                          << ", anti_nu_mu = " << anumuPDG << ", anti_nu_tau = "
                          << anutauPDG;
+    
+    // Tabulate the shower parametrization once per run, or take it from file
+    if (!lut.isFilled()) {
+        if (lutFile.empty()) {
+            lut.fill();
+            edm::LogInfo("ZdcShower") << "ZdcShowerLibrary: parametrization tabulated in memory";
+        } else {
+            edm::FileInPath fp(lutFile);
+            std::string fullName = fp.fullPath();
+            if (!lut.load(fullName)) {
+                edm::LogError("ZdcShower") << "ZdcShowerLibrary: reading " << fullName << " failed";
+                throw cms::Exception("Unknown", "ZdcShowerLibrary")
+                    << "Reading of lookup table " << fullName << " fails\n";
+            }
+            edm::LogInfo("ZdcShower") << "ZdcShowerLibrary: lookup table read from " << fullName;
+        }
+    }
+    
+    // Showers from full simulation, used wherever the library has entries
+    if (libBinStart.empty() && !libFile.empty()) {
+        edm::FileInPath fp(libFile);
+        loadLibrary(fp.fullPath());
+    }
+}
+
+void ZdcShowerLibrary::loadLibrary(const std::string& fileName) {
+    
+    TFile* file = TFile::Open(fileName.c_str());
+    if (file == 0 || file->IsZombie()) {
+        edm::LogError("ZdcShower") << "ZdcShowerLibrary: opening " << fileName << " failed";
+        throw cms::Exception("Unknown", "ZdcShowerLibrary")
+            << "Opening of shower library " << fileName << " fails\n";
+    }
+    TTree*    tree  = dynamic_cast<TTree*>(file->Get("ZdcShowers"));
+    TVectorD* eBins = dynamic_cast<TVectorD*>(file->Get("EnergyBins"));
+    TVectorD* xBins = dynamic_cast<TVectorD*>(file->Get("XBins"));
+    TVectorD* yBins = dynamic_cast<TVectorD*>(file->Get("YBins"));
+    if (tree == 0 || eBins == 0 || xBins == 0 || yBins == 0 ||
+        eBins->GetNrows() < 2 || xBins->GetNrows() < 2 || yBins->GetNrows() < 2 ||
+        tree->GetMaximum("nch") > nChannels) {
+        edm::LogError("ZdcShower") << "ZdcShowerLibrary: " << fileName << " is not a ZDC shower library";
+        throw cms::Exception("Unknown", "ZdcShowerLibrary")
+            << "Shower library " << fileName << " has no ZdcShowers tree, no binning"
+            << " or more than " << nChannels << " channels per shower\n";
+    }
+    libEBins.assign(eBins->GetMatrixArray(), eBins->GetMatrixArray()+eBins->GetNrows());
+    libXBins.assign(xBins->GetMatrixArray(), xBins->GetMatrixArray()+xBins->GetNrows());
+    libYBins.assign(yBins->GetMatrixArray(), yBins->GetMatrixArray()+yBins->GetNrows());
+    int nE = libEBins.size()-1, nX = libXBins.size()-1, nY = libYBins.size()-1;
+    int nBins = ZdcShowerLUT::NClass*nE*nX*nY;
+    
+    int   cls, nch;
+    float energy, x, y, npe[nChannels];
+    tree->SetBranchAddress("cls",    &cls);
+    tree->SetBranchAddress("energy", &energy);
+    tree->SetBranchAddress("x",      &x);
+    tree->SetBranchAddress("y",      &y);
+    tree->SetBranchAddress("nch",    &nch);
+    tree->SetBranchAddress("npe",    npe);
+    
+    // read all showers, then sort them by bin
+    Long64_t           nEntries = tree->GetEntries();
+    std::vector<int>   bin(nEntries, -1);
+    std::vector<float> energies(nEntries), yields(nEntries*nChannels, 0.f);
+    libBinStart.assign(nBins+1, 0);
+    for (Long64_t k = 0; k < nEntries; k++) {
+        tree->GetEntry(k);
+        int ie = findBin(libEBins, energy);
+        int ix = findBin(libXBins, x);
+        int iy = findBin(libYBins, y);
+        if (cls < 0 || cls >= ZdcShowerLUT::NClass || ie < 0 || ix < 0 || iy < 0 || energy <= 0.)
+            continue;
+        bin[k]      = ((cls*nE + ie)*nX + ix)*nY + iy;
+        energies[k] = energy;
+        std::copy(npe, npe+nch, &yields[k*nChannels]);
+        libBinStart[bin[k]+1]++;
+    }
+    for (int ib = 0; ib < nBins; ib++) libBinStart[ib+1] += libBinStart[ib];
+    
+    int nStored = libBinStart[nBins];
+    std::vector<int> next(libBinStart.begin(), libBinStart.end()-1);
+    libEnergy.assign(nStored, 0.f);
+    libNpe.assign(nStored*nChannels, 0.f);
+    for (Long64_t k = 0; k < nEntries; k++) {
+        if (bin[k] < 0) continue;
+        int i = next[bin[k]]++;
+        libEnergy[i] = energies[k];
+        std::copy(&yields[k*nChannels], &yields[k*nChannels]+nChannels, &libNpe[i*nChannels]);
+    }
+    file->Close();
+    delete file;
+    
+    int nEmpty = 0;
+    for (int ib = 0; ib < nBins; ib++)
+        if (libBinStart[ib+1] == libBinStart[ib]) nEmpty++;
+    edm::LogInfo("ZdcShower") << "ZdcShowerLibrary: " << nStored << " of " << nEntries
+                              << " showers read from " << fileName << " in " << nBins
+                              << " bins (" << nE << " energy x " << nX << " x x " << nY
+                              << " y x " << ZdcShowerLUT::NClass << " classes), " << nEmpty
+                              << " bins empty";
+    
+    matchParametrization(nE, nX, nY);
+}
+
+void ZdcShowerLibrary::matchParametrization(int nE, int nX, int nY) {
+    
+    // Mean signal of the parametrization, summed over the channels, at the
+    // centre of each library bin against the library showers of that bin:
+    // their ratio per class is the factor that brings the parametrization
+    // to the photoelectron scale of the library
+    for (int cls = 0; cls < ZdcShowerLUT::NClass; cls++) {
+        double sumLib = 0., sumPar = 0.;
+        for (int ie = 0; ie < nE; ie++) {
+            for (int ix = 0; ix < nX; ix++) {
+                double xc = 0.5*(libXBins[ix]+libXBins[ix+1]);
+                for (int iy = 0; iy < nY; iy++) {
+                    double yc = 0.5*(libYBins[iy]+libYBins[iy+1]);
+                    int ib = ((cls*nE + ie)*nX + ix)*nY + iy;
+                    G4ThreeVector hitPoint(xc*cm, yc*cm, 0.);
+                    float fsum = 0.;
+                    for (int i = 0; i < nChannels; i++)
+                        fsum += channelResponse(hitPoint,cls,chSection[i],chNumber[i]);
+                    for (int k = libBinStart[ib]; k < libBinStart[ib+1]; k++) {
+                        double eav = 0., esig = 0., edis = 0.;
+                        lut.getParameters(cls,libEnergy[k],xc,yc,eav,esig,edis);
+                        if (eav <= 0.) continue;
+                        sumPar += fsum*eav*GeV;
+                        for (int i = 0; i < nChannels; i++) sumLib += libNpe[k*nChannels+i];
+                    }
+                }
+            }
+        }
+        paramScale[cls] = (sumPar > 0. && sumLib > 0.) ? sumLib/sumPar : 1.;
+        if (paramScale[cls] < 0.5 || paramScale[cls] > 2.)
+            edm::LogWarning("ZdcShower") << "ZdcShowerLibrary: the parametrization of class "
+                                         << cls << " differs from the library showers by a"
+                                         << " factor " << paramScale[cls] << "; it is rescaled,"
+                                         << " check that the library was made with the same"
+                                         << " ZdcSD settings";
+        else
+            edm::LogInfo("ZdcShower") << "ZdcShowerLibrary: parametrization of class " << cls
+                                      << " scaled by " << paramScale[cls]
+                                      << " to match the library showers";
+    }
 }
 
-std::vector<ZdcShowerLibrary::Hit> & ZdcShowerLibrary::getHits(G4Step * aStep, bool & ok) {
+int ZdcShowerLibrary::findBin(const std::vector<double>& edges, double value) {
+    std::vector<double>::const_iterator it = std::upper_bound(edges.begin(), edges.end(), value);
+    if (it == edges.begin() || it == edges.end()) return -1;
+    return int(it - edges.begin()) - 1;
+}
+
+bool ZdcShowerLibrary::sampleLibrary(const G4ThreeVector& hitPoint, double energy, int iparCode,
+                                     double* dE) {
+    
+    if (libEnergy.empty()) return false;
+    int ie = findBin(libEBins, energy/GeV);
+    int ix = findBin(libXBins, hitPoint.x()/cm);
+    int iy = findBin(libYBins, hitPoint.y()/cm);
+    if (ie < 0 || ix < 0 || iy < 0) return false;
+    
+    int nE = libEBins.size()-1, nX = libXBins.size()-1, nY = libYBins.size()-1;
+    int ib = ((iparCode*nE + ie)*nX + ix)*nY + iy;
+    int first = libBinStart[ib];
+    int n     = libBinStart[ib+1] - first;
+    if (n <= 0) return false;
+    
+    // A whole recorded shower is used, so that the correlations between the
+    // channels (and between the RPD pads) are those of the full simulation;
+    // the yields follow the energy within the bin
+    int k = first + std::min(int(G4UniformRand()*n), n-1);
+    double scale = (energy/GeV)/libEnergy[k];
+    const float* npe = &libNpe[k*nChannels];
+    for (int i = 0; i < nChannels; i++) dE[i] = scale*npe[i];
+    
+    LogDebug("ZdcShower") << "ZdcShowerLibrary::sampleLibrary: shower " << k << " of bin "
+                          << ib << " (" << n << " showers) for " << energy/GeV << " GeV at ("
+                          << hitPoint.x()/cm << ", " << hitPoint.y()/cm << ") cm, class "
+                          << iparCode << ", scale " << scale;
+    return true;
+}
+
+const ZdcShowerLibrary::Hits & ZdcShowerLibrary::getHits(G4Step * aStep, bool & ok) {
     
     G4StepPoint * preStepPoint  = aStep->GetPreStepPoint();
     G4StepPoint * postStepPoint = aStep->GetPostStepPoint();
     G4Track *     track    = aStep->GetTrack();
     
-    const G4DynamicParticle *aParticle = track->GetDynamicParticle();
-    G4ThreeVector momDir = aParticle->GetMomentumDirection();
     double energy = preStepPoint->GetKineticEnergy();
     G4ThreeVector hitPoint = preStepPoint->GetPosition();
     G4ThreeVector hitPointOrig = preStepPoint->GetPosition();
     G4int parCode  = track->GetDefinition()->GetPDGEncoding();
     
-    hits.clear();
+    hits.nHit = 0;
     
     ok = false;
     if (parCode == geantinoPDG)
         return hits;
     ok = true;
     
-    G4ThreeVector pos;
-    G4ThreeVector posLocal;
-    double tSlice = (postStepPoint->GetGlobalTime())/nanosecond;
-    
-    int nHit = 0;
-    HcalZDCDetId::Section section;
-    bool side = false;
-    int channel = 0;
-    double xx,yy,zz;
-    double xxlocal, yylocal, zzlocal;
+    hits.time = (postStepPoint->GetGlobalTime())/nanosecond;
+    bool side = (hitPointOrig.z() > 0.) ?  true : false;
     
-    ZdcShowerLibrary::Hit oneHit;
-    side = (hitPointOrig.z() > 0.) ?  true : false;
-    
-    float xWidthEM = fabs(theXChannelBoundaries[0] - theXChannelBoundaries[1]);
-    float zWidthEM = fabs(theZSectionBoundaries[0] - theZSectionBoundaries[1]);
-    float zWidthHAD = fabs(theZHadChannelBoundaries[0] - theZHadChannelBoundaries[1]);
-    float xWidthRPD = fabs(theXrpdChannelBoundaries[0] - theXrpdChannelBoundaries[1]);
-    float yWidthRPD = fabs(theYrpdChannelBoundaries[0] - theYrpdChannelBoundaries[1]);
-    float zWidthRPD = fabs(theZSectionBoundaries[1]-theZSectionBoundaries[2]);
+    // Note: coodinates of hit are relative to center of detector (X0,Y0,Z0)
+    hitPoint.setX(hitPointOrig.x()-X0);
+    hitPoint.setY(hitPointOrig.y()-Y0);
+    double setZ= (hitPointOrig.z()> 0.) ? hitPointOrig.z()- Z0 : fabs(hitPointOrig.z()) - Z0;
+    hitPoint.setZ(setZ);
     
-    for (int i = 0; i < npe; i++) {
-        if(i < 5){
-            section = HcalZDCDetId::EM;
-            channel = i+1;
-            xxlocal = theXChannelBoundaries[i]+(xWidthEM/2.);
-            xx = xxlocal + X0;
-            yy = 0.0;
-            yylocal = yy + Y0;
-            zzlocal = theZSectionBoundaries[0]+(zWidthEM/2.);
-            zz = (hitPointOrig.z() > 0.) ? zzlocal + Z0 : zzlocal - Z0;
-            pos = G4ThreeVector(xx,yy,zz);
-            posLocal = G4ThreeVector(xxlocal,yylocal,zzlocal);
-        }
-        else if((i > 4) && (i < 9)){
-            section = HcalZDCDetId::HAD;
-            channel = i - 4;
-            xxlocal = 0.0;
-            xx = xxlocal + X0;
-            yylocal = 0;
-            yy = yylocal + Y0;
-            zzlocal = (hitPointOrig.z() > 0.) ?
-            theZHadChannelBoundaries[i-5] + (zWidthHAD/2.) : theZHadChannelBoundaries[i-5] - (zWidthHAD/2.);
-            zz = (hitPointOrig.z() > 0.) ? zzlocal +  Z0 : zzlocal -  Z0;
-            pos = G4ThreeVector(xx,yy,zz);
-            posLocal = G4ThreeVector(xxlocal,yylocal,zzlocal);
-        }
-        else if( i > 8 ) {
-            section = HcalZDCDetId::RPD;
-            channel = i-8;
-            xxlocal = theXrpdChannelBoundaries[(i-9)%4]+(xWidthRPD/2.);
-            xx = xxlocal + X0;
-            yylocal = theYrpdChannelBoundaries[(i-9)/4]+(yWidthRPD/2.);
-            yy = yylocal + Y0;
-            zzlocal = theZSectionBoundaries[0]+(zWidthRPD/2.);
-            zz = (hitPointOrig.z() > 0.) ? zzlocal + Z0 : zzlocal - Z0;
-            pos = G4ThreeVector(xx,yy,zz);
-            posLocal = G4ThreeVector(xxlocal,yylocal,zzlocal);
-        }
+    // Take a shower from the library if it covers this track, else use the
+    // parametrization
+    int iparCode = encodePartID(parCode);
+    double dE[nChannels];
+    if (!sampleLibrary(hitPoint,energy,iparCode,dE)) {
         
-        oneHit.position = pos;
-        oneHit.entryLocal = posLocal;
-        oneHit.depth    = channel;
-        oneHit.time     = tSlice;
-        oneHit.detID    = HcalZDCDetId(section,side,channel);
+        // The parametrization depends only on the track, not on the channel:
+        // look it up once and share it between all channels
+        double eav = 0., esig = 0., edis = 0.;
+        getParametersFromLibrary(hitPoint,energy,iparCode,eav,esig,edis);
         
+        // put the parametrization on the photoelectron scale of the library
+        // showers it is mixed with (1 without a library)
+        eav  *= paramScale[iparCode];
+        esig *= paramScale[iparCode];
         
-        // Note: coodinates of hit are relative to center of detector (X0,Y0,Z0)
-        hitPoint.setX(hitPointOrig.x()-X0);
-        hitPoint.setY(hitPointOrig.y()-Y0);
-        double setZ= (hitPointOrig.z()> 0.) ? hitPointOrig.z()- Z0 : fabs(hitPointOrig.z()) - Z0;
-        hitPoint.setZ(setZ);
+        if (eav <0. || edis <0.) {
+            LogDebug("ZdcShower")
+            <<" Negative everage energy from parametrization \n"
+            <<" eaverage: "<<eav/GeV << " (GeV)"
+            <<" esigma: "<<esig/GeV << "  (GeV)"
+            <<" edist: "<<edis  << " (GeV)";
+            return hits;
+        }
+        
+        // Response of all channels, then the fluctuations of all of them in one go
+        float fact[nChannels];
+        int   nphot[nChannels];
+        for (int i = 0; i < nChannels; i++)
+            fact[i] = channelResponse(hitPoint,iparCode,chSection[i],chNumber[i]);
+        fluctuation.shoot(G4Random::getTheEngine(),int(edis),eav,esig,nChannels,fact,nphot);
+        for (int i = 0; i < nChannels; i++) dE[i] = nphot[i];
+    }
+    
+    for (int i = 0; i < nChannels; i++) {
         
-        int dE = getEnergyFromLibrary(hitPoint,momDir,energy,parCode,section,side,channel);
+        // channels without signal get no hit
+        if (dE[i] <= 0.) continue;
         
-        int iparCode = encodePartID(parCode);
+        int nHit = hits.nHit;
+        hits.index[nHit] = i;
+        hits.detID[nHit] = chDetID[side][i];
         if (iparCode == 0 ) {
-            oneHit.DeEM  = dE;
-            oneHit.DeHad = 0.;
+            hits.DeEM[nHit]  = dE[i];
+            hits.DeHad[nHit] = 0.;
         } else {
-            oneHit.DeEM  = 0;
-            oneHit.DeHad = dE;
+            hits.DeEM[nHit]  = 0;
+            hits.DeHad[nHit] = dE[i];
         }
         
-        hits.push_back(oneHit);
-        
         LogDebug("ZdcShower")
         //std::cout
         << "\nZdcShowerLibrary:Generated Hit " << nHit
         <<" orig hit pos " << hitPointOrig
         <<" orig hit pos local coord" << hitPoint
-        <<" new position " << (hits[nHit].position)
-        <<" Channel " <<(hits[nHit].depth)
+        <<" new position " << chPosition[side][i]
+        <<" Channel " << chNumber[i]
         <<" side "<< side
-        <<" Time " <<(hits[nHit].time)
-        <<" DetectorID " << (hits[nHit].detID)
-        <<" Had Energy " << (hits[nHit].DeHad)
-        <<" EM Energy  " << (hits[nHit].DeEM)
+        <<" Time " << hits.time
+        <<" DetectorID " << hits.detID[nHit]
+        <<" Had Energy " << hits.DeHad[nHit]
+        <<" EM Energy  " << hits.DeEM[nHit]
         <<"\n";
-        nHit++;
+        hits.nHit++;
     }
     return hits;
 }
 
-
-int ZdcShowerLibrary::getEnergyFromLibrary(const G4ThreeVector& hitPoint, const G4ThreeVector& momDir, double energy,
-                                           G4int parCode,HcalZDCDetId::Section section, bool side, int channel){
-    int nphotons = -1;
+void ZdcShowerLibrary::getParametersFromLibrary(const G4ThreeVector& hitPoint, double energy, int iparCode,
+                                                double& eav, double& esig, double& edis){
     
     energy =energy/GeV;
     
+    //change to cm for parametrization
+    float xin = hitPoint.x()/cm;
+    float yin = hitPoint.y()/cm;
+    
+    lut.getParameters(iparCode,energy,xin,yin,eav,esig,edis);
+    
     LogDebug("ZdcShower")
-    //std::cout
-    <<"\n ZdcShowerLibrary::getEnergyFromLibrary input/output variables:"
-    <<" phi: "<<59.2956*momDir.phi()
-    <<" theta: "<<59.2956*momDir.theta()
-    <<" xin : "<<hitPoint.x()
-    <<" yin : "<<hitPoint.y()
+    <<"\n ZdcShowerLibrary::getParametersFromLibrary input/output variables:"
+    <<" xin : "<<xin<< "(cm)"
+    <<" yin : "<<yin<< "(cm)"
     <<" zin : "<<hitPoint.z()
     <<" track en: " <<energy<< "(GeV)"
-    <<" section: "<<section
-    <<" side: "<<side
-    <<" channel: "<< channel
-    <<" partID: "<<parCode;
-    //std::cout<<std::endl;
-    
-    // these varables are not used for now
-    //float phi   = 59.2956*momDir.phi();
-    //float theta = 59.2956*momDir.theta();
-    //float zin = hitPoint.z();
-    //int isection = int(section);
-    //int iside = (side)? 1 : 2;
-    
-    int iparCode  = encodePartID(parCode);
-    
-    double eav = 0.;
-    double esig = 0.;
-    double edis = 0.;
+    <<" partID: "<<iparCode
+    <<" eaverage: "<<eav << " (GeV)"
+    <<" esigma: "<<esig << "  (GeV)"
+    <<" edist: "<<edis;
     
+    // Convert from GeV to MeV for the code
+    eav = eav*GeV;
+    esig= esig*GeV;
+}
+
+float ZdcShowerLibrary::channelResponse(const G4ThreeVector& hitPoint, int iparCode,
+                                        HcalZDCDetId::Section section, int channel) const {
     float xin = hitPoint.x();
-    float yin = hitPoint.y();
     float fact = 0.;
     
     if(section == 1 && iparCode !=0){
@@ -237,66 +443,9 @@ int ZdcShowerLibrary::getEnergyFromLibrary(const G4ThreeVector& hitPoint, const
             if(theXChannelBoundaries[channel-1]< xin + X0)fact = 1.0;
     }
     
-    if(section==3 && iparCode!=0) fact=0.18; //Figure out later
-    
-    //change to cm for parametrization
-    yin = yin/cm;
-    xin = xin/cm;
-    
-    if (iparCode==0){
-        eav = ((((((-0.0002*xin-2.0e-13)*xin+0.0022)*xin+1.0e-11)*xin-0.0217)*xin-3.0e-10)*xin+1.0028)*
-        (((0.0001*yin + 0.0056)*yin + 0.0508)*yin + 1.0)*300.0*pow((energy/300.0),0.99); // EM
-        esig = ((((((0.0005*xin - 1.0e-12)*xin - 0.0052)*xin + 5.0e-11)*xin + 0.032)*xin -
-                 2.0e-10)*xin + 1.0)*(((0.0006*yin + 0.0071)*yin - 0.031)*yin + 1.0)*30.0*pow((energy/300.0),0.54);// EM
-        edis = 1.0;
-    }else{
-        eav = ((((((-0.0002*xin-2.0e-13)*xin+0.0022)*xin+1.0e-11)*xin-0.0217)*xin-3.0e-10)*xin+1.0028)*
-        (((0.0001*yin + 0.0056)*yin + 0.0508)*yin + 1.0)*300.0*pow((energy/300.0),1.12);// HD
-        esig = ((((((0.0005*xin - 1.0e-12)*xin - 0.0052)*xin + 5.0e-11)*xin + 0.032)*xin -
-                 2.0e-10)*xin + 1.0)*(((0.0006*yin + 0.0071)*yin - 0.031)*yin + 1.0)*54.0*pow((energy/300.0),0.93); //HD
-        edis = 3.0;
-    }
-    
-    if(eav <0. || edis <0.){
-        LogDebug("ZdcShower")
-        <<" Negative everage energy from parametrization \n"
-        <<" xin: "<<xin<< "(cm)"
-        <<" yin: "<<yin<< "(cm)"
-        <<" track en: " <<energy<< "(GeV)"
-        <<" eaverage: "<<eav/GeV << " (GeV)"
-        <<" esigma: "<<esig/GeV << "  (GeV)"
-        <<" edist: "<<edis  << " (GeV)"
-        <<" dE hit: "<<nphotons/GeV<<  " (GeV)";
-        return 0;
-    }
-    
-    // Convert from GeV to MeV for the code
-    eav = eav*GeV;
-    esig= esig*GeV;
-    
-    while(nphotons == -1 || nphotons > int(eav + 5.*esig))
-        nphotons = (int)(fact*photonFluctuation(eav, esig, edis));
-    
-    LogDebug("ZdcShower")
-    //std::cout
-    <<" track en: " <<energy<< "(GeV)"
-    <<" eaverage: "<<eav/GeV << " (GeV)"
-    <<" esigma: "<<esig/GeV << "  (GeV)"
-    <<" edist: "<<edis  << " (GeV)"
-    <<" dE hit: "<<nphotons/GeV<<  " (GeV)";
-    //std::cout<<std::endl;
+    if(section == HcalZDCDetId::RPD && iparCode !=0) fact = rpdHadResponse;
     
-    return nphotons; 
-}
-
-int ZdcShowerLibrary::photonFluctuation(double eav, double esig,double edis){
-    int nphot=0;
-    double efluct = 0.;
-    if(edis == 1.0) efluct = eav+esig*CLHEP::RandGaussQ::shoot();
-    if(edis == 3.0) efluct = eav+esig*CLHEP::RandLandau::shoot();
-    nphot = int(efluct);
-    if(nphot<0)nphot = 0;
-    return nphot;
+    return fact;
 }
 
 int ZdcShowerLibrary::encodePartID(G4int parCode){
@@ -308,3 +457,20 @@ int ZdcShowerLibrary::encodePartID(G4int parCode){
     } else { return iparCode; }
     return iparCode;
 }
+
+int ZdcShowerLibrary::channelIndex(const HcalZDCDetId& id) {
+    int channel = id.channel();
+    switch (id.section()) {
+    case HcalZDCDetId::EM:
+        return (channel >= 1 && channel <= nEMChannels) ? channel-1 : -1;
+    case HcalZDCDetId::HAD:
+        return (channel >= 1 && channel <= nHADChannels) ? nEMChannels+channel-1 : -1;
+    case HcalZDCDetId::RPD:
+        // the channel field has 4 bits: pad 16 reads back as 0
+        if (channel == 0) channel = nRPDChannels;
+        return (channel >= 1 && channel <= nRPDChannels) ?
+            nEMChannels+nHADChannels+channel-1 : -1;
+    default:
+        return -1;
+    }
+}
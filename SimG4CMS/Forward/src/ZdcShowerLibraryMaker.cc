@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcShowerLibraryMaker.cc
+// Description: Records fully simulated ZDC showers into a shower library
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ZdcShowerLibraryMaker.h"
+#include "SimG4CMS/Calo/interface/CaloG4Hit.h"
+#include "SimG4CMS/Calo/interface/CaloG4HitCollection.h"
+#include "DataFormats/HcalDetId/interface/HcalZDCDetId.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SDManager.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "CLHEP/Units/GlobalSystemOfUnits.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TVectorD.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+ZdcShowerLibraryMaker::ZdcShowerLibraryMaker(const edm::ParameterSet &p) :
+  hcID(-1), file(0), tree(0), nStored(0), entered(false), zside(0), cls(0), nch(nChannels),
+  energy(0), x(0), y(0) {
+
+  edm::ParameterSet m_Maker = p.getParameter<edm::ParameterSet>("ZdcShowerLibraryMaker");
+  verbosity     = m_Maker.getUntrackedParameter<int>("Verbosity",0);
+  fileName      = m_Maker.getParameter<std::string>("FileName");
+  hitCollection = m_Maker.getUntrackedParameter<std::string>("HitCollection","ZDCHITS");
+  eBins         = m_Maker.getParameter<std::vector<double> >("EnergyBins");
+  xBins         = m_Maker.getParameter<std::vector<double> >("XBins");
+  yBins         = m_Maker.getParameter<std::vector<double> >("YBins");
+  const std::vector<double>* bins[3] = {&eBins, &xBins, &yBins};
+  for (int k = 0; k < 3; ++k) {
+    if (bins[k]->size() < 2 || !std::is_sorted(bins[k]->begin(), bins[k]->end()))
+      throw cms::Exception("Unknown", "ZdcShowerLibraryMaker")
+        << "EnergyBins, XBins and YBins need at least two edges in increasing order\n";
+  }
+  std::fill(npe, npe+nChannels, 0.f);
+
+  file = new TFile(fileName.c_str(), "RECREATE");
+  tree = new TTree("ZdcShowers", "ZDC shower library");
+  tree->Branch("cls",    &cls,    "cls/I");
+  tree->Branch("energy", &energy, "energy/F");
+  tree->Branch("x",      &x,      "x/F");
+  tree->Branch("y",      &y,      "y/F");
+  tree->Branch("nch",    &nch,    "nch/I");
+  tree->Branch("npe",    npe,     "npe[nch]/F");
+
+  edm::LogInfo("ForwardSim") << "ZdcShowerLibraryMaker: showers of " << hitCollection
+                             << " written to " << fileName << " with "
+                             << eBins.size()-1 << " energy bins ("
+                             << eBins.front() << "-" << eBins.back() << " GeV), "
+                             << xBins.size()-1 << " x " << yBins.size()-1
+                             << " entry point bins";
+}
+
+ZdcShowerLibraryMaker::~ZdcShowerLibraryMaker() {
+
+  file->cd();
+  tree->Write("", TObject::kOverwrite);
+  TVectorD vE(eBins.size(), &eBins[0]);
+  TVectorD vX(xBins.size(), &xBins[0]);
+  TVectorD vY(yBins.size(), &yBins[0]);
+  vE.Write("EnergyBins", TObject::kOverwrite);
+  vX.Write("XBins", TObject::kOverwrite);
+  vY.Write("YBins", TObject::kOverwrite);
+  file->Close();
+  delete file;
+  edm::LogInfo("ForwardSim") << "ZdcShowerLibraryMaker: " << nStored
+                             << " showers written to " << fileName;
+}
+
+void ZdcShowerLibraryMaker::update(const BeginOfRun * run) {
+
+  // all volumes of the ZDC: the primary enters the library shower at its
+  // first step in one of them
+  lvZdc.clear();
+  const G4LogicalVolumeStore * lvs = G4LogicalVolumeStore::GetInstance();
+  std::vector<G4LogicalVolume*>::const_iterator lvcite;
+  for (lvcite = lvs->begin(); lvcite != lvs->end(); lvcite++) {
+    if ((*lvcite)->GetName().compare(0, 3, "ZDC") == 0) lvZdc.push_back(*lvcite);
+  }
+  std::sort(lvZdc.begin(), lvZdc.end());
+  if (lvZdc.empty())
+    edm::LogWarning("ForwardSim") << "ZdcShowerLibraryMaker: no ZDC volume in the geometry";
+
+  // the collection exists once the sensitive detectors are built
+  hcID = G4SDManager::GetSDMpointer()->GetCollectionID(hitCollection);
+  if (hcID < 0)
+    edm::LogWarning("ForwardSim") << "ZdcShowerLibraryMaker: no hit collection " << hitCollection;
+}
+
+void ZdcShowerLibraryMaker::update(const BeginOfEvent * evt) {
+  entered = false;
+  std::fill(npe, npe+nChannels, 0.f);
+}
+
+void ZdcShowerLibraryMaker::update(const G4Step * aStep) {
+
+  if (entered || aStep->GetTrack()->GetTrackID() != 1) return;
+  const G4StepPoint* preStepPoint = aStep->GetPreStepPoint();
+  const G4LogicalVolume* lv = preStepPoint->GetPhysicalVolume()->GetLogicalVolume();
+  if (!std::binary_search(lvZdc.begin(), lvZdc.end(), lv)) return;
+
+  // same coordinates as ZdcShowerLibrary: relative to the ZDC centre
+  entered = true;
+  const G4ThreeVector & pos = preStepPoint->GetPosition();
+  int pdg = aStep->GetTrack()->GetDefinition()->GetPDGEncoding();
+  cls     = (std::abs(pdg) == 11 || pdg == 22) ? ZdcShowerLUT::EM : ZdcShowerLUT::HAD;
+  energy  = preStepPoint->GetKineticEnergy()/GeV;
+  x       = (pos.x()-X0)/cm;
+  y       = (pos.y()-Y0)/cm;
+  zside   = (pos.z() > 0.) ? 1 : -1;
+  if (verbosity > 0)
+    edm::LogInfo("ForwardSim") << "ZdcShowerLibraryMaker: primary " << pdg << " of "
+                               << energy << " GeV enters " << lv->GetName()
+                               << " at (" << x << ", " << y << ") cm";
+}
+
+void ZdcShowerLibraryMaker::update(const EndOfEvent * evt) {
+
+  if (!entered) {
+    LogDebug("ForwardSim") << "ZdcShowerLibraryMaker: primary did not reach the ZDC";
+    return;
+  }
+  G4HCofThisEvent* allHC = (*evt)()->GetHCofThisEvent();
+  CaloG4HitCollection* theHC = (hcID >= 0 && allHC != 0) ?
+    (CaloG4HitCollection*) allHC->GetHC(hcID) : 0;
+  if (theHC == 0) {
+    edm::LogWarning("ForwardSim") << "ZdcShowerLibraryMaker: no hit collection " << hitCollection;
+    return;
+  }
+
+  // signal of each channel on the side hit by the primary
+  for (int ihit = 0; ihit < theHC->entries(); ihit++) {
+    CaloG4Hit*   hit = (*theHC)[ihit];
+    HcalZDCDetId id(hit->getUnitID());
+    int          ich = ZdcShowerLibrary::channelIndex(id);
+    if (ich >= 0 && id.zside() == zside) npe[ich] += hit->getEnergyDeposit();
+  }
+  tree->Fill();
+  nStored++;
+
+  if (verbosity > 0) {
+    double sum = 0;
+    for (int i = 0; i < nChannels; i++) sum += npe[i];
+    edm::LogInfo("ForwardSim") << "ZdcShowerLibraryMaker: shower " << nStored << " class "
+                               << cls << " " << energy << " GeV, " << sum
+                               << " photoelectrons in " << theHC->entries() << " hits";
+  }
+}
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: ZdcStepRecorder.cc
+// Description: Columnar, compressed step record file written in the
+//              background
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Forward/interface/ZdcStepRecorder.h"
+
+#include <cstring>
+#include <sstream>
+
+#include <zlib.h>
+
+const char ZdcStepRecorder::fileMagic[8] = {'Z','D','C','S','T','E','P','S'};
+
+ZdcStepRecorder::ZdcStepRecorder(const std::string & fileName,
+                                 const std::vector<std::string> & columns,
+                                 unsigned int blockRows, unsigned int nBlocks,
+                                 int compression) :
+  file(0), nColumns(columns.size()), blockRows(blockRows > 0 ? blockRows : 1),
+  compression(compression), nRecords(0), current(0), stopping(false),
+  failed(false) {
+
+  file = std::fopen(fileName.c_str(), "wb");
+  if (file == 0) return;
+
+  uint32_t head[2] = {fileVersion, nColumns};
+  bool ok = (std::fwrite(fileMagic, sizeof(fileMagic), 1, file) == 1 &&
+             std::fwrite(head, sizeof(head), 1, file) == 1);
+  for (unsigned int k = 0; k < nColumns && ok; ++k) {
+    uint32_t length = columns[k].size();
+    ok = (std::fwrite(&length, sizeof(length), 1, file) == 1 &&
+          std::fwrite(columns[k].data(), 1, length, file) == length);
+  }
+  if (!ok) {
+    std::fclose(file);
+    file = 0;
+    return;
+  }
+
+  // one block is filled while the others wait for (or are with) the writer
+  blocks.resize(nBlocks > 1 ? nBlocks : 2);
+  for (unsigned int k = 0; k < blocks.size(); ++k) {
+    blocks[k].nRows = 0;
+    blocks[k].data.resize(nColumns*this->blockRows);
+    if (k > 0) toFill.push_back(&blocks[k]);
+  }
+  current = &blocks[0];
+  writer  = std::thread(&ZdcStepRecorder::writeLoop, this);
+}
+
+ZdcStepRecorder::~ZdcStepRecorder() {
+  close();
+}
+
+bool ZdcStepRecorder::good() const {
+  // the blocks exist once the header is written
+  std::lock_guard<std::mutex> guard(lock);
+  return (!blocks.empty() && !failed);
+}
+
+void ZdcStepRecorder::fill(const float * record) {
+
+  if (current == 0) return;
+  float * row = &(current->data[current->nRows]);
+  for (unsigned int k = 0; k < nColumns; ++k) row[k*blockRows] = record[k];
+  ++nRecords;
+  if (++(current->nRows) == blockRows) submit();
+}
+
+void ZdcStepRecorder::close() {
+
+  if (current == 0) return;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (current->nRows > 0) toWrite.push_back(current);
+    current  = 0;
+    stopping = true;
+  }
+  changed.notify_all();
+  writer.join();
+  if (std::fclose(file) != 0) failed = true;
+  file = 0;
+}
+
+void ZdcStepRecorder::submit() {
+
+  std::unique_lock<std::mutex> guard(lock);
+  toWrite.push_back(current);
+  changed.notify_all();
+  while (toFill.empty()) changed.wait(guard);
+  current = toFill.front();
+  toFill.pop_front();
+  current->nRows = 0;
+}
+
+void ZdcStepRecorder::writeLoop() {
+
+  std::vector<unsigned char> buffer;
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    while (toWrite.empty() && !stopping) changed.wait(guard);
+    if (toWrite.empty()) break;
+    Block * block = toWrite.front();
+    guard.unlock();
+    bool ok = writeBlock(*block, buffer);
+    guard.lock();
+    toWrite.pop_front();
+    toFill.push_back(block);
+    if (!ok) failed = true;
+    changed.notify_all();
+  }
+}
+
+bool ZdcStepRecorder::writeBlock(const Block & block, std::vector<unsigned char> & buffer) {
+
+  if (failed) return false;
+  uint32_t nRows = block.nRows;
+  if (std::fwrite(&nRows, sizeof(nRows), 1, file) != 1) return false;
+  uLong  size  = nRows*sizeof(float);
+  buffer.resize(compressBound(size));
+  for (unsigned int k = 0; k < nColumns; ++k) {
+    uLongf nBytes = buffer.size();
+    const Bytef * column = reinterpret_cast<const Bytef*>(&(block.data[k*blockRows]));
+    if (compress2(&buffer[0], &nBytes, column, size, compression) != Z_OK) return false;
+    uint32_t length = nBytes;
+    if (std::fwrite(&length, sizeof(length), 1, file) != 1 ||
+        std::fwrite(&buffer[0], 1, nBytes, file) != nBytes) return false;
+  }
+  return true;
+}
+
+bool ZdcStepRecorder::read(const std::string & fileName,
+                           std::vector<std::string> & columns,
+                           std::vector<std::vector<float> > & data,
+                           std::string & error) {
+
+  columns.clear();
+  data.clear();
+  std::FILE * in = std::fopen(fileName.c_str(), "rb");
+  if (in == 0) {
+    error = "cannot be opened";
+    return false;
+  }
+
+  char     magic[8];
+  uint32_t head[2];
+  if (std::fread(magic, sizeof(magic), 1, in) != 1 || std::memcmp(magic, fileMagic, sizeof(magic)) != 0 ||
+      std::fread(head, sizeof(head), 1, in) != 1 || head[0] != fileVersion) {
+    std::ostringstream os;
+    os << "is not a version " << fileVersion << " ZDC step record file";
+    error = os.str();
+    std::fclose(in);
+    return false;
+  }
+  for (uint32_t k = 0; k < head[1]; ++k) {
+    uint32_t length;
+    std::string name;
+    if (std::fread(&length, sizeof(length), 1, in) == 1) {
+      name.resize(length);
+      if (length == 0 || std::fread(&name[0], 1, length, in) == length) {
+        columns.push_back(name);
+        continue;
+      }
+    }
+    error = "has a truncated header";
+    std::fclose(in);
+    return false;
+  }
+  data.resize(columns.size());
+
+  std::vector<unsigned char> buffer;
+  uint32_t nRows;
+  while (std::fread(&nRows, sizeof(nRows), 1, in) == 1) {
+    for (unsigned int k = 0; k < columns.size(); ++k) {
+      uint32_t nBytes;
+      bool ok = (std::fread(&nBytes, sizeof(nBytes), 1, in) == 1);
+      if (ok) {
+        buffer.resize(nBytes > 0 ? nBytes : 1);
+        ok = (std::fread(&buffer[0], 1, nBytes, in) == nBytes);
+      }
+      if (ok) {
+        std::vector<float> & column = data[k];
+        size_t first = column.size();
+        column.resize(first+nRows);
+        uLongf size = nRows*sizeof(float);
+        ok = (nRows == 0 ||
+              (uncompress(reinterpret_cast<Bytef*>(&column[first]), &size, &buffer[0], nBytes) == Z_OK &&
+               size == nRows*sizeof(float)));
+      }
+      if (!ok) {
+        error = "has a truncated or corrupted block";
+        std::fclose(in);
+        return false;
+      }
+    }
+  }
+  std::fclose(in);
+  return true;
+}
@@ -5,6 +5,9 @@
 
 #include "SimG4CMS/Forward/interface/ZdcTestAnalysis.h"
 #include "SimG4CMS/Forward/interface/ZdcNumberingScheme.h"
+#include "SimG4CMS/Forward/interface/ZdcStepRecorder.h"
+
+#include "G4LogicalVolumeStore.hh"
 
 #include "TFile.h"
 #include <cmath>
@@ -22,7 +25,9 @@ enum ntzdce_elements {
   ntzdce_enem,ntzdce_enhad,ntzdce_hitenergy,ntzdce_x,ntzdce_y,ntzdce_z,ntzdce_time,ntzdce_etot
 };
 
-ZdcTestAnalysis::ZdcTestAnalysis(const edm::ParameterSet &p){
+ZdcTestAnalysis::ZdcTestAnalysis(const edm::ParameterSet &p) :
+  zdcOutputEventFile(0), zdcOutputStepFile(0), zdcStepRecorder(0),
+  zdcstepntuple(0), zdceventntuple(0) {
   //constructor
   edm::ParameterSet m_Anal = p.getParameter<edm::ParameterSet>("ZdcTestAnalysis");
   verbosity    = m_Anal.getParameter<int>("Verbosity");
@@ -38,6 +43,8 @@ ZdcTestAnalysis::ZdcTestAnalysis(const edm::ParameterSet &p){
    if (doNTzdcstep  > 0){
      std::cout <<" Step Ntuple will be created"<< std::endl;
      std::cout <<" Step Ntuple file: "<<stepNtFileName<<std::endl;
+     if (doNTzdcstep == 2)
+       std::cout <<" (as compressed step records, see zdcStepRecordToNtuple)"<<std::endl;
    }
    if (doNTzdcevent > 0){
      std::cout <<" Event Ntuple will be created"<< std::endl;
@@ -46,7 +53,7 @@ ZdcTestAnalysis::ZdcTestAnalysis(const edm::ParameterSet &p){
    std::cout<<"============================================================================"<<std::endl;
    std::cout<<std::endl;
 
-   if (doNTzdcstep  > 0)
+   if (doNTzdcstep && doNTzdcstep != 2)
      zdcstepntuple = 
        new TNtuple("NTzdcstep","NTzdcstep",
 		   "evt:trackid:charge:pdgcode:x:y:z:stepl:stepe:eta:phi:vpx:vpy:vpz:idx:idl:pvtype:ncherphot");
@@ -85,12 +92,43 @@ void ZdcTestAnalysis::update(const BeginOfRun * run) {
   //run
 
  std::cout << std::endl << "ZdcTestAnalysis: Begining of Run"<< std::endl; 
-  if (doNTzdcstep) { 
+  if (doNTzdcstep == 2) {
+    // one file for all runs
+    if (zdcStepRecorder == 0) {
+      const char * columns[ntzdcs_ncherphot+1] = {
+        "evt", "trackid", "charge", "pdgcode", "x", "y", "z", "stepl", "stepe",
+        "eta", "phi", "vpx", "vpy", "vpz", "idx", "idl", "pvtype", "ncherphot"};
+      zdcStepRecorder = new ZdcStepRecorder(stepNtFileName,
+  					  std::vector<std::string>(columns, columns+ntzdcs_ncherphot+1));
+      if (zdcStepRecorder->good())
+        std::cout << "ZDCTestAnalysis: output step record file created"<< std::endl;
+      else
+        std::cout << "ZDCTestAnalysis: cannot create step record file "<< stepNtFileName << std::endl;
+    }
+  } else if (doNTzdcstep) { 
     std::cout << "ZDCTestAnalysis: output step file created"<< std::endl;
     TString stepfilename = stepNtFileName;
     zdcOutputStepFile = new TFile(stepfilename,"RECREATE");
 
   }
+
+  // step volume types by logical volume: physical and logical volumes have
+  // the same name in geometries built from DDD
+  if (doNTzdcstep) {
+    const char * pvNames[9] = {"ZDC_EMLayer", "ZDC_EMAbsorber", "ZDC_EMFiber",
+			       "ZDC_HadLayer", "ZDC_HadAbsorber", "ZDC_HadFiber",
+			       "ZDC_PhobosLayer", "ZDC_PhobosAbsorber", "ZDC_PhobosFiber"};
+    const int pvTypeCodes[9] = {1, 2, 3, 7, 8, 9, 11, 12, 13};
+    pvTypes.clear();
+    const G4LogicalVolumeStore * lvs = G4LogicalVolumeStore::GetInstance();
+    std::vector<G4LogicalVolume*>::const_iterator lvcite;
+    for (lvcite = lvs->begin(); lvcite != lvs->end(); lvcite++) {
+      for (int k = 0; k < 9; k++) {
+	if ((*lvcite)->GetName() == pvNames[k])
+	  pvTypes.push_back(std::pair<const G4LogicalVolume*,int>(*lvcite, pvTypeCodes[k]));
+      }
+    }
+  }
   
   if (doNTzdcevent) {
     std::cout << "ZDCTestAnalysis: output event file created"<< std::endl;
@@ -128,7 +166,6 @@ void ZdcTestAnalysis::update(const G4Step * aStep) {
     G4Track * theTrack    = aStep->GetTrack();
     G4int theTrackID      = theTrack->GetTrackID();
     G4double theCharge    = theTrack->GetDynamicParticle()->GetCharge();
-    G4String particleType = theTrack->GetDefinition()->GetParticleName();
     G4int pdgcode         = theTrack->GetDefinition()->GetPDGEncoding();
     
     G4ThreeVector vert_mom = theTrack->GetVertexMomentumDirection();
@@ -139,8 +176,6 @@ void ZdcTestAnalysis::update(const G4Step * aStep) {
     double phi = atan2(vpy,vpx);
     
     G4ThreeVector hitPoint = preStepPoint->GetPosition();
-    G4ThreeVector localPoint = theTrack->GetTouchable()->GetHistory()->
-    GetTopTransform().TransformPoint(hitPoint);
     
     const G4VTouchable* touch = aStep->GetPreStepPoint()->GetTouchable();
     int idx = touch->GetReplicaNumber(0);
@@ -150,66 +185,36 @@ void ZdcTestAnalysis::update(const G4Step * aStep) {
     int historyDepth = touch->GetHistoryDepth();
 
     if (historyDepth > 0) {
-      std::vector<int>                theReplicaNumbers(historyDepth);
-      std::vector<G4VPhysicalVolume*> thePhysicalVolumes(historyDepth);
-      std::vector<G4String>           thePVnames(historyDepth);
-      std::vector<G4LogicalVolume*>   theLogicalVolumes(historyDepth);
-      std::vector<G4String>           theLVnames(historyDepth);
-      std::vector<G4Material*>        theMaterials(historyDepth);
-      std::vector<G4String>           theMaterialNames(historyDepth);
-      
-      for (int jj = 0; jj < historyDepth; jj++) {
-	theReplicaNumbers[jj] = touch->GetReplicaNumber(jj);
-	thePhysicalVolumes[jj] = touch->GetVolume(jj);
-	thePVnames[jj] = thePhysicalVolumes[jj]->GetName();
-	theLogicalVolumes[jj] = thePhysicalVolumes[jj]->GetLogicalVolume();
-	theLVnames[jj] = theLogicalVolumes[jj]->GetName();
-	theMaterials[jj] = theLogicalVolumes[jj]->GetMaterial();
-	theMaterialNames[jj] = theMaterials[jj]->GetName();
-	if (verbosity >= 2)
-	  std::cout << " GHD " << jj << ": " << theReplicaNumbers[jj] << ","
-		       << thePVnames[jj] << "," << theLVnames[jj] << ","
-		    << theMaterialNames[jj]  << std::endl;
+      if (verbosity >= 2) {
+	for (int jj = 0; jj < historyDepth; jj++) {
+	  G4LogicalVolume * lv = touch->GetVolume(jj)->GetLogicalVolume();
+	  std::cout << " GHD " << jj << ": " << touch->GetReplicaNumber(jj) << ","
+		    << touch->GetVolume(jj)->GetName() << "," << lv->GetName() << ","
+		    << lv->GetMaterial()->GetName()  << std::endl;
+	}
       }
 
-      idLayer = theReplicaNumbers[1];
-      if (thePVnames[0] == "ZDC_EMLayer")
-	thePVtype = 1;
-      else if (thePVnames[0] == "ZDC_EMAbsorber")
-	thePVtype = 2;
-      else if (thePVnames[0] == "ZDC_EMFiber")
-	thePVtype = 3;
-      else if (thePVnames[0] == "ZDC_HadLayer")
-	thePVtype = 7;
-      else if (thePVnames[0] == "ZDC_HadAbsorber")
-	thePVtype = 8;
-      else if (thePVnames[0] == "ZDC_HadFiber")
-	thePVtype = 9;
-      else if (thePVnames[0] == "ZDC_PhobosLayer")
-	thePVtype = 11;
-      else if (thePVnames[0] == "ZDC_PhobosAbsorber")
-	thePVtype = 12;
-      else if (thePVnames[0] == "ZDC_PhobosFiber")
-      thePVtype = 13;
-      else {
-	thePVtype = 0;
-	if (verbosity >= 2)
-	  std::cout << " pvtype=0 hd=" << historyDepth << " " << theReplicaNumbers[0] << ","
-		    << thePVnames[0] << "," << theLVnames[0] << "," << theMaterialNames[0] << std::endl;
+      idLayer = touch->GetReplicaNumber(1);
+      const G4LogicalVolume * lv = touch->GetVolume(0)->GetLogicalVolume();
+      thePVtype = 0;
+      for (unsigned int k = 0; k < pvTypes.size(); k++) {
+	if (pvTypes[k].first == lv) {
+	  thePVtype = pvTypes[k].second;
+	  break;
+	}
       }
+      if (thePVtype == 0 && verbosity >= 2)
+	std::cout << " pvtype=0 hd=" << historyDepth << " " << idx << ","
+		  << touch->GetVolume(0)->GetName() << "," << lv->GetName() << ","
+		  << lv->GetMaterial()->GetName() << std::endl;
     }    
     else if (historyDepth == 0) { 
-      int theReplicaNumber = touch->GetReplicaNumber(0);
-      G4VPhysicalVolume* thePhysicalVolume = touch->GetVolume(0);
-      G4String thePVname = thePhysicalVolume->GetName();
-      G4LogicalVolume * theLogicalVolume = thePhysicalVolume->GetLogicalVolume();
-      G4String theLVname = theLogicalVolume->GetName();
-      G4Material * theMaterial = theLogicalVolume->GetMaterial();
-      G4String theMaterialName = theMaterial->GetName();
-      if (verbosity >= 2)
-	std::cout << " hd=0 " << theReplicaNumber << "," 
-		  << thePVname << "," << theLVname << "," 
-		  << theMaterialName << std::endl;
+      if (verbosity >= 2) {
+	const G4LogicalVolume * lv = touch->GetVolume(0)->GetLogicalVolume();
+	std::cout << " hd=0 " << idx << "," 
+		  << touch->GetVolume(0)->GetName() << "," << lv->GetName() << "," 
+		  << lv->GetMaterial()->GetName() << std::endl;
+      }
     }
     else {
       std::cout << " hd<0:  hd=" << historyDepth << std::endl;
@@ -235,7 +240,10 @@ void ZdcTestAnalysis::update(const G4Step * aStep) {
     zdcsteparray[ntzdcs_idl] = (float)idLayer;
     zdcsteparray[ntzdcs_pvtype] = thePVtype;
     zdcsteparray[ntzdcs_ncherphot] = NCherPhot;
-    zdcstepntuple->Fill(zdcsteparray);
+    if (zdcStepRecorder)
+      zdcStepRecorder->fill(zdcsteparray);
+    else
+      zdcstepntuple->Fill(zdcsteparray);
 
   }
 }
@@ -389,7 +397,14 @@ void ZdcTestAnalysis::update(const EndOfEvent * evt) {
 void ZdcTestAnalysis::update(const EndOfRun * run) {;}
 
 void ZdcTestAnalysis::finish(){
-  if (doNTzdcstep) {
+  if (zdcStepRecorder) {
+    zdcStepRecorder->close();
+    std::cout << "ZdcTestAnalysis: " << zdcStepRecorder->records() << " step records "
+	      << (zdcStepRecorder->good() ? "written" : "NOT written correctly")
+	      << " for event: "<<eventIndex<<std::endl;
+    delete zdcStepRecorder;
+    zdcStepRecorder = 0;
+  } else if (zdcOutputStepFile) {
     zdcOutputStepFile->cd();
     zdcstepntuple->Write();
     std::cout << "ZdcTestAnalysis: Ntuple step  written for event: "<<eventIndex<<std::endl;
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: benchQuartzFiberResponse.cc
+// Description: Time per call of the tabulated d_qz acceptance of
+//              QuartzFiberResponse against the closed form, for the ZDC
+//              (fibers at 0 deg) and CASTOR (plates at 45 deg) constants,
+//              and the largest difference between the two.
+//              Usage: benchQuartzFiberResponse [number of calls]
+///////////////////////////////////////////////////////////////////////////////
+#include "SimG4CMS/Forward/interface/QuartzFiberResponse.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  template <class C>
+  void bench(const char * name, double thFibDir, unsigned int n) {
+
+    QuartzFiberResponse<C> response(thFibDir);
+
+    // steps of charged particles above threshold, all directions
+    std::mt19937 engine(12345);
+    std::uniform_real_distribution<double> thDist(0., pi);
+    std::uniform_real_distribution<double> betaDist(C::bThreshold, 1.);
+    std::vector<double> th(n), beta(n);
+    for (unsigned int k = 0; k < n; ++k) {
+      th[k]   = thDist(engine);
+      beta[k] = betaDist(engine);
+    }
+
+    double sumTable = 0., sumExact = 0.;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (unsigned int k = 0; k < n; ++k) sumTable += response.acceptance(th[k], beta[k]);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (unsigned int k = 0; k < n; ++k) sumExact += response.acceptanceExact(th[k], beta[k]);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double maxDiff = 0.;
+    for (unsigned int k = 0; k < n; ++k) {
+      double diff = std::fabs(response.acceptance(th[k], beta[k]) - response.acceptanceExact(th[k], beta[k]));
+      if (diff > maxDiff) maxDiff = diff;
+    }
+
+    double nsTable = std::chrono::duration<double, std::nano>(t1-t0).count()/n;
+    double nsExact = std::chrono::duration<double, std::nano>(t2-t1).count()/n;
+    std::cout << name << ": table " << nsTable << " ns/call, closed form "
+              << nsExact << " ns/call, speedup " << nsExact/nsTable
+              << ", max |difference| " << maxDiff << " (mean "
+              << sumTable/n << " vs " << sumExact/n << ")" << std::endl;
+  }
+}
+
+int main(int argc, char ** argv) {
+
+  unsigned int n = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+  if (n == 0) n = 1;
+  bench<ZdcQuartzFiber>("ZDC", 0., n);
+  bench<CastorQuartzFiber>("CASTOR", 45., n);
+  return 0;
+}
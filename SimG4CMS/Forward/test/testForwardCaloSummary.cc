@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: testForwardCaloSummary.cc
+// Description: Channel indices of the ZDC and CASTOR units in
+//              ForwardCaloSummary
+///////////////////////////////////////////////////////////////////////////////
+#include <cppunit/extensions/HelperMacros.h>
+#include "SimG4CMS/Forward/interface/ForwardCaloSummary.h"
+
+#include <vector>
+
+class testForwardCaloSummary : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(testForwardCaloSummary);
+  CPPUNIT_TEST(checkZdcIndex);
+  CPPUNIT_TEST(checkCastorIndex);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkZdcIndex();
+  void checkCastorIndex();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testForwardCaloSummary);
+
+void testForwardCaloSummary::checkZdcIndex() {
+
+  // every channel of both sides has its own index
+  std::vector<int> seen(ForwardCaloSummary::nZdc, 0);
+  const HcalZDCDetId::Section sections[3] = {HcalZDCDetId::EM, HcalZDCDetId::HAD, HcalZDCDetId::RPD};
+  const int channels[3] = {(int)ForwardCaloSummary::nZdcEM, (int)ForwardCaloSummary::nZdcHad,
+                           (int)ForwardCaloSummary::nZdcRPD};
+  for (int side = 0; side < 2; ++side)
+    for (int s = 0; s < 3; ++s)
+      for (int channel = 1; channel <= channels[s]; ++channel) {
+        int index = ForwardCaloSummary::zdcIndex(HcalZDCDetId(sections[s], side == 1, channel).rawId());
+        CPPUNIT_ASSERT(index >= 0 && index < (int)ForwardCaloSummary::nZdc);
+        if (index >= 0 && index < (int)ForwardCaloSummary::nZdc) ++seen[index];
+      }
+  for (unsigned int k = 0; k < seen.size(); ++k) CPPUNIT_ASSERT_EQUAL(1, seen[k]);
+
+  // RPD pad 16 (channel bits 0) is not HAD channel 4
+  uint32_t pad16 = HcalZDCDetId(HcalZDCDetId::RPD, true, 16).rawId();
+  uint32_t had4  = HcalZDCDetId(HcalZDCDetId::HAD, true, 4).rawId();
+  CPPUNIT_ASSERT(ForwardCaloSummary::zdcIndex(pad16) != ForwardCaloSummary::zdcIndex(had4));
+  CPPUNIT_ASSERT_EQUAL((int)ForwardCaloSummary::nZdc-1, ForwardCaloSummary::zdcIndex(pad16));
+  CPPUNIT_ASSERT_EQUAL(0, ForwardCaloSummary::zdcIndex(HcalZDCDetId(HcalZDCDetId::EM, false, 1).rawId()));
+
+  // not channels
+  CPPUNIT_ASSERT_EQUAL(-1, ForwardCaloSummary::zdcIndex(HcalZDCDetId(HcalZDCDetId::EM, true, 6).rawId()));
+  CPPUNIT_ASSERT_EQUAL(-1, ForwardCaloSummary::zdcIndex(HcalZDCDetId(HcalZDCDetId::EM, true, 0).rawId()));
+  CPPUNIT_ASSERT_EQUAL(-1, ForwardCaloSummary::zdcIndex(HcalZDCDetId(HcalZDCDetId::HAD, false, 5).rawId()));
+  CPPUNIT_ASSERT_EQUAL(-1, ForwardCaloSummary::zdcIndex(0));
+}
+
+void testForwardCaloSummary::checkCastorIndex() {
+
+  std::vector<int> seen(ForwardCaloSummary::nCastor, 0);
+  for (int side = 0; side < 2; ++side)
+    for (int sector = 1; sector <= 16; ++sector)
+      for (int module = 1; module <= 14; ++module) {
+        int index = ForwardCaloSummary::castorIndex(HcalCastorDetId(side == 1, sector, module).rawId());
+        CPPUNIT_ASSERT(index >= 0 && index < (int)ForwardCaloSummary::nCastor);
+        if (index >= 0 && index < (int)ForwardCaloSummary::nCastor) ++seen[index];
+      }
+  for (unsigned int k = 0; k < seen.size(); ++k) CPPUNIT_ASSERT_EQUAL(1, seen[k]);
+}
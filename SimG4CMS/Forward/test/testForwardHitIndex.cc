@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: testForwardHitIndex.cc
+// Description: Lookup, growth and reset of ForwardHitIndex
+///////////////////////////////////////////////////////////////////////////////
+#include <cppunit/extensions/HelperMacros.h>
+#include "SimG4CMS/Forward/interface/ForwardHitIndex.h"
+
+#include <vector>
+
+namespace {
+  struct TestHit {
+    int      trackID, timeSliceID;
+    uint32_t unitID;
+  };
+}
+
+class testForwardHitIndex : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(testForwardHitIndex);
+  CPPUNIT_TEST(checkFind);
+  CPPUNIT_TEST(checkGrow);
+  CPPUNIT_TEST(checkClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkFind();
+  void checkGrow();
+  void checkClear();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testForwardHitIndex);
+
+void testForwardHitIndex::checkFind() {
+
+  ForwardHitIndex<TestHit> index(16);
+  TestHit a = {1, 0, 1111}, b = {1, 1, 1111}, c = {2, 0, 1111}, d = {1, 0, 2222};
+  index.insert(a.trackID, a.timeSliceID, a.unitID, &a);
+  index.insert(b.trackID, b.timeSliceID, b.unitID, &b);
+  index.insert(c.trackID, c.timeSliceID, c.unitID, &c);
+  index.insert(d.trackID, d.timeSliceID, d.unitID, &d);
+  CPPUNIT_ASSERT_EQUAL(4u, index.size());
+
+  // each key finds its own hit
+  CPPUNIT_ASSERT(index.find(1, 0, 1111) == &a);
+  CPPUNIT_ASSERT(index.find(1, 1, 1111) == &b);
+  CPPUNIT_ASSERT(index.find(2, 0, 1111) == &c);
+  CPPUNIT_ASSERT(index.find(1, 0, 2222) == &d);
+  CPPUNIT_ASSERT(index.find(2, 1, 1111) == 0);
+  CPPUNIT_ASSERT(index.find(1, 0, 3333) == 0);
+
+  // the first hit indexed under a key is kept
+  TestHit e = a;
+  index.insert(e.trackID, e.timeSliceID, e.unitID, &e);
+  CPPUNIT_ASSERT_EQUAL(4u, index.size());
+  CPPUNIT_ASSERT(index.find(1, 0, 1111) == &a);
+
+  // negative time slices (the keys are not read back from the hit)
+  TestHit f = {3, -1, 1111};
+  index.insert(f.trackID, f.timeSliceID, f.unitID, &f);
+  CPPUNIT_ASSERT(index.find(3, -1, 1111) == &f);
+  CPPUNIT_ASSERT(index.find(3, 0, 1111) == 0);
+}
+
+void testForwardHitIndex::checkGrow() {
+
+  // many more hits than the initial capacity, with colliding low bits
+  ForwardHitIndex<TestHit> index(4);
+  std::vector<TestHit> hits;
+  for (int track = 1; track <= 50; ++track)
+    for (int slice = 0; slice < 20; ++slice) {
+      TestHit hit = {track, slice, uint32_t(1000*slice)};
+      hits.push_back(hit);
+    }
+  for (unsigned int k = 0; k < hits.size(); ++k)
+    index.insert(hits[k].trackID, hits[k].timeSliceID, hits[k].unitID, &hits[k]);
+  CPPUNIT_ASSERT_EQUAL((unsigned int)hits.size(), index.size());
+  for (unsigned int k = 0; k < hits.size(); ++k)
+    CPPUNIT_ASSERT(index.find(hits[k].trackID, hits[k].timeSliceID, hits[k].unitID) == &hits[k]);
+  CPPUNIT_ASSERT(index.find(51, 0, 0) == 0);
+}
+
+void testForwardHitIndex::checkClear() {
+
+  ForwardHitIndex<TestHit> index;
+  TestHit a = {1, 5, 42};
+  index.insert(a.trackID, a.timeSliceID, a.unitID, &a);
+  CPPUNIT_ASSERT(index.find(1, 5, 42) == &a);
+  index.clear();
+  CPPUNIT_ASSERT_EQUAL(0u, index.size());
+  CPPUNIT_ASSERT(index.find(1, 5, 42) == 0);
+  index.insert(a.trackID, a.timeSliceID, a.unitID, &a);
+  CPPUNIT_ASSERT(index.find(1, 5, 42) == &a);
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: testLibraryHitAccumulator.cc
+// Description: Sums of LibraryHitAccumulator by cell and time slice
+///////////////////////////////////////////////////////////////////////////////
+#include <cppunit/extensions/HelperMacros.h>
+#include "SimG4CMS/Forward/interface/LibraryHitAccumulator.h"
+
+class testLibraryHitAccumulator : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(testLibraryHitAccumulator);
+  CPPUNIT_TEST(checkSums);
+  CPPUNIT_TEST(checkSliceUnit);
+  CPPUNIT_TEST(checkClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkSums();
+  void checkSliceUnit();
+  void checkClear();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testLibraryHitAccumulator);
+
+void testLibraryHitAccumulator::checkSums() {
+
+  LibraryHitAccumulator acc(4, 1.);
+  acc.add(2, 10.2, 1., 0., 7);
+  acc.add(1, 10.5, 0., 2.);
+  acc.add(2, 10.9, 3., 4., 8);
+  acc.add(2, 11.1, 5., 0.);
+
+  // one entry per (cell, slice), in the order of the first deposit
+  const std::vector<LibraryHitAccumulator::Entry> & e = acc.entries();
+  CPPUNIT_ASSERT_EQUAL(size_t(3), e.size());
+  CPPUNIT_ASSERT_EQUAL(2, e[0].cell);
+  CPPUNIT_ASSERT_EQUAL(10, e[0].slice);
+  CPPUNIT_ASSERT_EQUAL(7, e[0].tag);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(10.2, e[0].time, 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(4., e[0].em, 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(4., e[0].had, 1e-12);
+  CPPUNIT_ASSERT_EQUAL(1, e[1].cell);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2., e[1].had, 1e-12);
+  CPPUNIT_ASSERT_EQUAL(2, e[2].cell);
+  CPPUNIT_ASSERT_EQUAL(11, e[2].slice);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(5., e[2].em, 1e-12);
+}
+
+void testLibraryHitAccumulator::checkSliceUnit() {
+
+  // with a 25 ns unit, as CaloSD's TimeSliceUnit may be set, deposits
+  // 1 ns apart share a slice
+  LibraryHitAccumulator acc(2, 25.);
+  acc.add(0, 10.2, 1., 0.);
+  acc.add(0, 11.1, 1., 0.);
+  acc.add(0, 24.9, 1., 0.);
+  acc.add(0, 25.0, 1., 0.);
+  const std::vector<LibraryHitAccumulator::Entry> & e = acc.entries();
+  CPPUNIT_ASSERT_EQUAL(size_t(2), e.size());
+  CPPUNIT_ASSERT_EQUAL(0, e[0].slice);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(3., e[0].em, 1e-12);
+  CPPUNIT_ASSERT_EQUAL(1, e[1].slice);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1., e[1].em, 1e-12);
+}
+
+void testLibraryHitAccumulator::checkClear() {
+
+  LibraryHitAccumulator acc(3, 1.);
+  acc.add(0, 1., 1., 0.);
+  acc.add(2, 1., 1., 0.);
+  acc.clear();
+  CPPUNIT_ASSERT(acc.empty());
+
+  // no sum of the previous shower is reused
+  acc.add(2, 1., 2., 0.);
+  CPPUNIT_ASSERT_EQUAL(size_t(1), acc.entries().size());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2., acc.entries()[0].em, 1e-12);
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: testTotemUnitIDCodec.cc
+// Description: TotemUnitIDCodec against the T1 unit IDs written before it
+//              (TotemNumberMerger and the TotemT1Organization layout)
+///////////////////////////////////////////////////////////////////////////////
+#include <cppunit/extensions/HelperMacros.h>
+#include "SimG4CMS/Forward/interface/TotemUnitIDCodec.h"
+
+class testTotemUnitIDCodec : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(testTotemUnitIDCodec);
+  CPPUNIT_TEST(checkPairing);
+  CPPUNIT_TEST(checkOldLayout);
+  CPPUNIT_TEST(checkCollection);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkPairing();
+  void checkOldLayout();
+  void checkCollection();
+
+private:
+  // unit ID as TotemT1Organization wrote it with TotemNumberMerger::Merge
+  static uint32_t oldUnitID(uint32_t position, uint32_t plane, uint32_t csc,
+                            uint32_t layer, uint32_t objectType) {
+    unsigned long c(plane+layer);
+    unsigned long pla(((c*(c+1))>>1)+plane);
+    return position*100000+5*(csc+7*(objectType+15*pla));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testTotemUnitIDCodec);
+
+void testTotemUnitIDCodec::checkPairing() {
+
+  // every value up to past 16782321, where the float split of
+  // TotemNumberMerger went wrong
+  for (uint32_t source = 0; source < 20000000; ++source) {
+    uint32_t value1, value2;
+    TotemUnitIDCodec::split(source, value1, value2);
+    if (TotemUnitIDCodec::merge(value1, value2) != source) {
+      CPPUNIT_ASSERT_EQUAL(source, TotemUnitIDCodec::merge(value1, value2));
+      break;
+    }
+  }
+  uint32_t value1, value2;
+  TotemUnitIDCodec::split(TotemUnitIDCodec::merge(3000, 2791), value1, value2);
+  CPPUNIT_ASSERT_EQUAL(uint32_t(3000), value1);
+  CPPUNIT_ASSERT_EQUAL(uint32_t(2791), value2);
+}
+
+void testTotemUnitIDCodec::checkOldLayout() {
+
+  // all the field values T1 uses: the IDs are the ones written before and
+  // decode back into the same fields
+  unsigned int nChecked = 0;
+  for (uint32_t position = 0; position < TotemUnitIDCodec::kPositions; ++position)
+    for (uint32_t plane = 0; plane <= TotemUnitIDCodec::kMaxPlane; ++plane)
+      for (uint32_t csc = 0; csc < TotemUnitIDCodec::kCSCs; ++csc)
+        for (uint32_t layer = 0; layer <= TotemUnitIDCodec::kMaxLayer; ++layer)
+          for (uint32_t type = 0; type < TotemUnitIDCodec::kObjectTypes; ++type) {
+            CPPUNIT_ASSERT(TotemUnitIDCodec::fits(position, plane, csc, layer, type));
+            uint32_t id = TotemUnitIDCodec::encode(position, plane, csc, layer, type);
+            CPPUNIT_ASSERT_EQUAL(oldUnitID(position, plane, csc, layer, type), id);
+            TotemUnitIDCodec::T1Fields f;
+            TotemUnitIDCodec::decode(id, f);
+            CPPUNIT_ASSERT_EQUAL(position, f.position);
+            CPPUNIT_ASSERT_EQUAL(plane, f.plane);
+            CPPUNIT_ASSERT_EQUAL(csc, f.csc);
+            CPPUNIT_ASSERT_EQUAL(layer, f.layer);
+            CPPUNIT_ASSERT_EQUAL(type, f.objectType);
+            ++nChecked;
+          }
+  CPPUNIT_ASSERT_EQUAL(5u*6u*7u*14u*15u, nChecked);
+
+  // plane and layer beyond the layout would reach the position field
+  CPPUNIT_ASSERT(!TotemUnitIDCodec::fits(0, 100, 0, 100, 0));
+  CPPUNIT_ASSERT(!TotemUnitIDCodec::fits(TotemUnitIDCodec::kPositions, 0, 0, 0, 0));
+}
+
+void testTotemUnitIDCodec::checkCollection() {
+
+  const unsigned int n = 4;
+  uint32_t ids[n] = {TotemUnitIDCodec::encode(0, 0, 0, 0, 0),
+                     TotemUnitIDCodec::encode(1, 5, 6, 13, 14),
+                     TotemUnitIDCodec::encode(2, 3, 2, 7, 1),
+                     TotemUnitIDCodec::encode(4, 1, 4, 12, 9)};
+  TotemUnitIDCodec::T1Fields fields[n];
+  TotemUnitIDCodec::decode(ids, n, fields);
+  for (unsigned int k = 0; k < n; ++k) {
+    TotemUnitIDCodec::T1Fields f;
+    TotemUnitIDCodec::decode(ids[k], f);
+    CPPUNIT_ASSERT_EQUAL(f.position, fields[k].position);
+    CPPUNIT_ASSERT_EQUAL(f.plane, fields[k].plane);
+    CPPUNIT_ASSERT_EQUAL(f.csc, fields[k].csc);
+    CPPUNIT_ASSERT_EQUAL(f.layer, fields[k].layer);
+    CPPUNIT_ASSERT_EQUAL(f.objectType, fields[k].objectType);
+  }
+  CPPUNIT_ASSERT_EQUAL(uint32_t(1), fields[1].position);
+  CPPUNIT_ASSERT_EQUAL(uint32_t(13), fields[1].layer);
+}
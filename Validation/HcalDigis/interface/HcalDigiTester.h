@@ -10,8 +10,10 @@
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 #include "CalibFormats/HcalObjects/interface/HcalDbService.h"
 #include <map>
+#include <vector>
 #include "Validation/HcalDigis/src/HcalSubdetDigiMonitor.h"
 
+#include "DataFormats/HcalDetId/interface/HcalDetId.h"
 #include "DataFormats/HcalDigi/interface/HBHEDataFrame.h"
 #include "DataFormats/HcalDigi/interface/HFDataFrame.h"
 #include "DataFormats/HcalDigi/interface/HODataFrame.h"
@@ -24,7 +26,7 @@ public:
   explicit HcalDigiTester(const edm::ParameterSet&);
   ~HcalDigiTester();
   virtual void analyze(const edm::Event&, const edm::EventSetup&);
-  template<class Digi>  void reco(const edm::Event&, const edm::EventSetup&, const edm::EDGetTokenT<edm::SortedCollection<Digi>  >  &);
+  template<class Digi>  void reco(const edm::Event&, const edm::EDGetTokenT<edm::SortedCollection<Digi>  >  &);
   virtual void endRun() ;  
 
   virtual void bookHistograms(DQMStore::IBooker &, edm::Run const &, edm::EventSetup const &);
@@ -32,6 +34,32 @@ public:
 
  private:
 
+  // pedestals and ADC->fC table (capid, adc) of one channel
+  struct ChannelCalib {
+    static const int nADC = 128;
+    double pedestal[4];
+    float  fC[4][nADC];
+  };
+
+  // per subdetector (1-4: HB, HE, HO, HF) state of one event; monitor is
+  // 0 for the subdetectors not selected
+  struct Subdet {
+    HcalSubdetDigiMonitor * monitor;
+    int    nevent;
+    int    seedSimHit;      // set to 1 if "seed" SimHit is found
+    bool   seedDone;
+    int    ieta_Sim, iphi_Sim;
+    double emax_Sim;
+    int    ndigis, Ndig;
+    double ampl_c[5];       // seed cell amplitude: total, depth 1-4
+    double ehits[5];        // seed cell SimHit energy: total, depth 1-4
+  };
+
+  template<class Digi>  void recoDigi(const Digi &, const HcalDetId &, Subdet &);
+  void scanSimHits(const edm::Event&);
+  void endEvent(Subdet &);
+  const ChannelCalib & calib(const HcalDetId &);
+
   double dR(double eta1, double phi1, double eta2, double phi2);
   void eval_occupancy();
 
@@ -58,11 +86,16 @@ public:
   edm::ESHandle<CaloGeometry> geometry ;
   edm::ESHandle<HcalDbService> conditions;
   float pedvalue;
-  int nevent1;
-  int nevent2;
-  int nevent3;
-  int nevent4;
   int nevtot;
+  int zsign_;
+  Subdet subdets_[5];
+
+  // calibrations of the channels met, cleared when HcalDbRecord changes
+  unsigned long long        calibCacheId_;
+  std::vector<int>          calibIndex_;
+  std::vector<ChannelCalib> calibs_;
+  ChannelCalib              calibOther_;
+  std::vector<double>       tool_;
   std::map<std::string, HcalSubdetDigiMonitor*> monitors_;
 
 };
@@ -29,493 +29,460 @@
 #include "CondFormats/HcalObjects/interface/HcalPedestal.h"
 #include "CondFormats/HcalObjects/interface/HcalPedestalWidth.h"
 
-template<class Digi >
-
-void HcalDigiTester::reco(const edm::Event& iEvent, const edm::EventSetup& iSetup, const edm::EDGetTokenT<edm::SortedCollection<Digi> > &tok) {
-  
-  
-  typename   edm::Handle<edm::SortedCollection<Digi> > digiCollection;
-  typename edm::SortedCollection<Digi>::const_iterator digiItr;
-     
-  // ADC2fC 
-  HcalCalibrations calibrations;
-  CaloSamples tool;
+namespace {
+  // dense index of the HB/HE/HO/HF channels for the calibration table
+  const int kCalibSubdets = 4;
+  const int kCalibEta     = 41;
+  const int kCalibPhi     = 72;
+  const int kCalibDepths  = 4;
+  const int kCalibChannels = kCalibSubdets*2*kCalibEta*kCalibPhi*kCalibDepths;
+
+  int calibIndex(const HcalDetId & cell) {
+    int sub   = cell.subdet();
+    int aieta = cell.ietaAbs();
+    int iphi  = cell.iphi();
+    int depth = cell.depth();
+    if (sub < 1 || sub > kCalibSubdets || aieta < 1 || aieta > kCalibEta ||
+	iphi < 1 || iphi > kCalibPhi || depth < 1 || depth > kCalibDepths)
+      return -1;
+    int zside = (cell.zside() > 0) ? 1 : 0;
+    return (((((sub-1)*2 + zside)*kCalibEta + aieta-1)*kCalibPhi + iphi-1)*kCalibDepths
+	    + depth-1);
+  }
+}
 
+const HcalDigiTester::ChannelCalib & HcalDigiTester::calib(const HcalDetId & cell) {
 
-  iEvent.getByToken (tok, digiCollection);
+  // pedestals and ADC->fC table of the channel, built once per IOV
+  int index = calibIndex(cell);
+  if (index >= 0 && calibIndex_[index] >= 0) return calibs_[calibIndex_[index]];
 
-  int subdet = 0;
-  if (hcalselector_ == "HB"  ) subdet = 1;
-  if (hcalselector_ == "HE"  ) subdet = 2;
-  if (hcalselector_ == "HO"  ) subdet = 3;
-  if (hcalselector_ == "HF"  ) subdet = 4; 
+  ChannelCalib c;
+  HcalCalibrations calibrations = conditions->getHcalCalibrations(cell);
+  const HcalQIECoder* channelCoder = conditions->getHcalCoder(cell);
+  const HcalQIEShape* shape = conditions->getHcalShape(channelCoder);
+  for (int capid = 0; capid < 4; capid++) {
+    c.pedestal[capid] = calibrations.pedestal(capid);
+    for (int adc = 0; adc < ChannelCalib::nADC; adc++)
+      c.fC[capid][adc] = channelCoder->charge(*shape, adc, capid);
+  }
 
-  if(subdet == 1) nevent1++;
-  if(subdet == 2) nevent2++;
-  if(subdet == 3) nevent3++;
-  if(subdet == 4) nevent4++;
-  
-  int zsign = 0;
-  if (zside_ == "+")  zsign =  1;
-  if (zside_ == "-")  zsign = -1;
+  if (index < 0) {   // not in the table (e.g. unexpected depth): not cached
+    calibOther_ = c;
+    return calibOther_;
+  }
+  calibIndex_[index] = calibs_.size();
+  calibs_.push_back(c);
+  return calibs_.back();
+}
 
-  int ndigis = 0;
-  //  amplitude for signal cell at diff. depths
-  double ampl1_c    = 0.;
-  double ampl2_c    = 0.;
-  double ampl3_c    = 0.;
-  double ampl4_c    = 0.;
-  double ampl_c     = 0.;
-
-  // is set to 1 if "seed" SimHit is found 
-  int seedSimHit  = 0;
- 
-  //  std::cout << " HcalDigiTester::reco :  "
-  // 	    << "subdet=" << subdet << "  noise="<< noise_ << std::endl;
- 
-  int ieta_Sim    =  9999;
-  int iphi_Sim    =  9999;
-  double emax_Sim = -9999.;
+void HcalDigiTester::scanSimHits(const edm::Event& iEvent) {
 
+  // seed SimHit of each subdetector and the SimHit energy of its cell,
+  // in one pass per event for all the subdetectors
+  edm::Handle<edm::PCaloHitContainer> hcalHits ;
+  iEvent.getByToken(tok_mc_,hcalHits); 
+  const edm::PCaloHitContainer * simhitResult = hcalHits.product () ;
     
-  // SimHits MC only
-  if( mc_ == "yes") {
-    edm::Handle<edm::PCaloHitContainer> hcalHits ;
-    iEvent.getByToken(tok_mc_,hcalHits); 
-    const edm::PCaloHitContainer * simhitResult = hcalHits.product () ;
-    
-    
-    if ( subdet != 0 && noise_ == 0) { // signal only SimHits
-      
-      for (std::vector<PCaloHit>::const_iterator simhits = simhitResult->begin ();         simhits != simhitResult->end () ;  ++simhits) {
-	
-	HcalDetId cell(simhits->id());
-	double en    = simhits->energy();
-	int sub      = cell.subdet();
-	int ieta     = cell.ieta();
-	if(ieta > 0) ieta--;
-	int iphi     = cell.iphi()-1; 
+  for (std::vector<PCaloHit>::const_iterator simhits = simhitResult->begin ();         simhits != simhitResult->end () ;  ++simhits) {
 	
+    HcalDetId cell(simhits->id());
+    double en    = simhits->energy();
+    int sub      = cell.subdet();
+    if (sub < 1 || sub > 4) continue;
+    Subdet & sd  = subdets_[sub];
+    if (sd.monitor == 0 || sd.seedDone) continue;
+    int ieta     = cell.ieta();
+    if(ieta > 0) ieta--;
+    int iphi     = cell.iphi()-1; 
 	
-	if(en > emax_Sim && sub == subdet) {
-	  emax_Sim = en;
-	  ieta_Sim = ieta;
-	  iphi_Sim = iphi;            
-	  // to limit "seed" SimHit energy in case of "multi" event  
-	  if (mode_ == "multi" && 
-           ((sub == 4 && en < 100. && en > 1.) 
-	    || ((sub !=4) && en < 1. && en > 0.02))) 
-	    {
-	      seedSimHit = 1;            
-	      break;   
-	    }
+    if(en > sd.emax_Sim) {
+      sd.emax_Sim = en;
+      sd.ieta_Sim = ieta;
+      sd.iphi_Sim = iphi;            
+      // to limit "seed" SimHit energy in case of "multi" event  
+      if (mode_ == "multi" && 
+	  ((sub == 4 && en < 100. && en > 1.) 
+	   || ((sub !=4) && en < 1. && en > 0.02))) 
+	{
+	  sd.seedSimHit = 1;            
+	  sd.seedDone   = true;
 	}
+    }
+  } // end of SimHits cycle
+
+  for (int sub = 1; sub <= 4; sub++) {
+    // found highest-energy SimHit for single-particle 
+    if(mode_ != "multi" && subdets_[sub].emax_Sim > 0.) subdets_[sub].seedSimHit = 1;
+  }
+
+  // SimHits once again: energy of the seed cell
+  for (std::vector<PCaloHit>::const_iterator simhits = simhitResult->begin ();         simhits != simhitResult->end () ;  ++simhits) {
 	
-      } // end of SimHits cycle
-      
-      
-      // found highest-energy SimHit for single-particle 
-      if(mode_ != "multi" && emax_Sim > 0.) seedSimHit = 1;
-    }   // end of SimHits
-    
-  } // end of mc_ == "yes"
+    HcalDetId cell(simhits->id());
+    int sub    = cell.subdet();
+    if (sub < 1 || sub > 4 || subdets_[sub].monitor == 0) continue;
+    Subdet & sd = subdets_[sub];
+    int ieta   = cell.ieta();
+    if(ieta > 0) ieta--;
+    int iphi   = cell.iphi()-1; 
+	
+    // take cell already found to be max energy in a particular subdet
+    if (ieta == sd.ieta_Sim && iphi == sd.iphi_Sim){  
+      int depth = cell.depth();
+      double en = simhits->energy();
+      sd.ehits[0] += en;
+      if(depth >= 1 && depth <= 4)  sd.ehits[depth] += en; 
+    }
+  }
+}
 
-  // CYCLE OVER CELLS ========================================================
-  int Ndig = 0;
+template<class Digi >
 
-  /*
-  std::cout << " HcalDigiTester::reco :     nevent 1,2,3,4 = "
-	    << nevent1 << " " << nevent2 << " " << nevent3 << " " 
-	    << nevent4 << std::endl;
-  */
+void HcalDigiTester::reco(const edm::Event& iEvent, const edm::EDGetTokenT<edm::SortedCollection<Digi> > &tok) {
+  
+  // one pass over the collection for all the selected subdetectors in it
+  typename   edm::Handle<edm::SortedCollection<Digi> > digiCollection;
+  typename edm::SortedCollection<Digi>::const_iterator digiItr;
+
+  iEvent.getByToken (tok, digiCollection);
 
   for (digiItr=digiCollection->begin();digiItr!=digiCollection->end();digiItr++) {
-    
     HcalDetId cell(digiItr->id()); 
-    int depth = cell.depth();
-    int iphi  = cell.iphi()-1;
-    int ieta  = cell.ieta();
-    if(ieta > 0) ieta--;
     int sub   = cell.subdet();
+    if (sub >= 1 && sub <= 4 && subdets_[sub].monitor != 0)
+      recoDigi(*digiItr, cell, subdets_[sub]);
+  }
+}
 
+template<class Digi >
+
+void HcalDigiTester::recoDigi(const Digi & digi, const HcalDetId & cell, Subdet & sd) {
+
+  HcalSubdetDigiMonitor * m = sd.monitor;
+  int depth = cell.depth();
+  int iphi  = cell.iphi()-1;
+  int ieta  = cell.ieta();
+  if(ieta > 0) ieta--;
+  int sub   = cell.subdet();
 
   //  amplitude for signal cell at diff. depths
-    double ampl     = 0.;
-    double ampl1    = 0.;
-    double ampl2    = 0.;
-    double ampl3    = 0.;
-    double ampl4    = 0.;
+  double ampl     = 0.;
+  double ampl1    = 0.;
+  double ampl2    = 0.;
+  double ampl3    = 0.;
+  double ampl4    = 0.;
     
-    // Gains, pedestals (once !) and only for "noise" case  
-    if ( ((nevent1 == 1 && subdet == 1) || 
-	  (nevent2 == 1 && subdet == 2) ||
-	  (nevent3 == 1 && subdet == 3) ||
-	  (nevent4 == 1 && subdet == 4)) && noise_ == 1 && sub == subdet) { 
-
-      HcalGenericDetId hcalGenDetId(digiItr->id());
-      const HcalPedestal* pedestal = conditions->getPedestal(hcalGenDetId);
-      const HcalGain*  gain = conditions->getGain(hcalGenDetId); 
-      const HcalGainWidth* gainWidth = 
+  // Gains, pedestals (once !) and only for "noise" case  
+  if ( sd.nevent == 1 && noise_ == 1) { 
+
+    HcalGenericDetId hcalGenDetId(digi.id());
+    const HcalPedestal* pedestal = conditions->getPedestal(hcalGenDetId);
+    const HcalGain*  gain = conditions->getGain(hcalGenDetId); 
+    const HcalGainWidth* gainWidth = 
 	conditions->getGainWidth(hcalGenDetId); 
-      const HcalPedestalWidth* pedWidth =
+    const HcalPedestalWidth* pedWidth =
 	conditions-> getPedestalWidth(hcalGenDetId);  
-      
-      double gainValue0 = gain->getValue(0);
-      double gainValue1 = gain->getValue(1);
-      double gainValue2 = gain->getValue(2);
-      double gainValue3 = gain->getValue(3);
-
-      double gainWidthValue0 = gainWidth->getValue(0);
-      double gainWidthValue1 = gainWidth->getValue(1);
-      double gainWidthValue2 = gainWidth->getValue(2);
-      double gainWidthValue3 = gainWidth->getValue(3);
-      
+    
+    double gainValue0 = gain->getValue(0);
+    double gainValue1 = gain->getValue(1);
+    double gainValue2 = gain->getValue(2);
+    double gainValue3 = gain->getValue(3);
+
+    double gainWidthValue0 = gainWidth->getValue(0);
+    double gainWidthValue1 = gainWidth->getValue(1);
+    double gainWidthValue2 = gainWidth->getValue(2);
+    double gainWidthValue3 = gainWidth->getValue(3);
+    
 
 
-      // some printout
-      /*
-      std::cout <<  " subdet = " << sub << "  ieta, iphi, depth : " 
+    // some printout
+    /*
+    std::cout <<  " subdet = " << sub << "  ieta, iphi, depth : " 
 		<< ieta << " " << iphi << " " << depth 
 		<< "  gain0 " << gainValue0 << "  gainWidth0 " 
 		<< gainWidthValue0
 		<< std::endl;
-      */
-      
-      double pedValue0 = pedestal->getValue(0);
-      double pedValue1 = pedestal->getValue(1);
-      double pedValue2 = pedestal->getValue(2);
-      double pedValue3 = pedestal->getValue(3);
-      
-      double pedWidth0 = pedWidth->getWidth(0);
-      double pedWidth1 = pedWidth->getWidth(1);
-      double pedWidth2 = pedWidth->getWidth(2);
-      double pedWidth3 = pedWidth->getWidth(3);
-      
-      if (depth == 1) {
+    */
+    
+    double pedValue0 = pedestal->getValue(0);
+    double pedValue1 = pedestal->getValue(1);
+    double pedValue2 = pedestal->getValue(2);
+    double pedValue3 = pedestal->getValue(3);
+    
+    double pedWidth0 = pedWidth->getWidth(0);
+    double pedWidth1 = pedWidth->getWidth(1);
+    double pedWidth2 = pedWidth->getWidth(2);
+    double pedWidth3 = pedWidth->getWidth(3);
+    
+    if (depth == 1) {
 
 	//        std::cout <<  "          depth = " << depth << std::endl;
-    
-	monitor()->fillmeGain0Depth1(gainValue0);
-	monitor()->fillmeGain1Depth1(gainValue1);
-	monitor()->fillmeGain2Depth1(gainValue2);
-	monitor()->fillmeGain3Depth1(gainValue3);
-
-	monitor()->fillmeGainWidth0Depth1(gainWidthValue0);
-	monitor()->fillmeGainWidth1Depth1(gainWidthValue1);
-	monitor()->fillmeGainWidth2Depth1(gainWidthValue2);
-	monitor()->fillmeGainWidth3Depth1(gainWidthValue3);
-
-	monitor()->fillmePed0Depth1(pedValue0);
-	monitor()->fillmePed1Depth1(pedValue1);
-	monitor()->fillmePed2Depth1(pedValue2);
-	monitor()->fillmePed3Depth1(pedValue3);
-
-        monitor()->fillmePedWidth0Depth1(pedWidth0);
-        monitor()->fillmePedWidth1Depth1(pedWidth1);
-        monitor()->fillmePedWidth2Depth1(pedWidth2);
-        monitor()->fillmePedWidth3Depth1(pedWidth3);
-
-	monitor()->fillmeGainMap1  (double(ieta), double(iphi), gainValue0);
-	monitor()->fillmePwidthMap1(double(ieta), double(iphi), pedWidth0) ;  
-      }
+  
+	m->fillmeGain0Depth1(gainValue0);
+	m->fillmeGain1Depth1(gainValue1);
+	m->fillmeGain2Depth1(gainValue2);
+	m->fillmeGain3Depth1(gainValue3);
+
+	m->fillmeGainWidth0Depth1(gainWidthValue0);
+	m->fillmeGainWidth1Depth1(gainWidthValue1);
+	m->fillmeGainWidth2Depth1(gainWidthValue2);
+	m->fillmeGainWidth3Depth1(gainWidthValue3);
+
+	m->fillmePed0Depth1(pedValue0);
+	m->fillmePed1Depth1(pedValue1);
+	m->fillmePed2Depth1(pedValue2);
+	m->fillmePed3Depth1(pedValue3);
+
+      m->fillmePedWidth0Depth1(pedWidth0);
+      m->fillmePedWidth1Depth1(pedWidth1);
+      m->fillmePedWidth2Depth1(pedWidth2);
+      m->fillmePedWidth3Depth1(pedWidth3);
+
+	m->fillmeGainMap1  (double(ieta), double(iphi), gainValue0);
+	m->fillmePwidthMap1(double(ieta), double(iphi), pedWidth0) ;  
+    }
 
-      if (depth == 2) {
+    if (depth == 2) {
 
 	//        std::cout <<  "          depth = " << depth << std::endl;
 
-	monitor()->fillmeGain0Depth2(gainValue0);
-	monitor()->fillmeGain1Depth2(gainValue1);
-	monitor()->fillmeGain2Depth2(gainValue2);
-	monitor()->fillmeGain3Depth2(gainValue3);
+	m->fillmeGain0Depth2(gainValue0);
+	m->fillmeGain1Depth2(gainValue1);
+	m->fillmeGain2Depth2(gainValue2);
+	m->fillmeGain3Depth2(gainValue3);
 
-	monitor()->fillmeGainWidth0Depth2(gainWidthValue0);
-	monitor()->fillmeGainWidth1Depth2(gainWidthValue1);
-	monitor()->fillmeGainWidth2Depth2(gainWidthValue2);
-	monitor()->fillmeGainWidth3Depth2(gainWidthValue3);
+	m->fillmeGainWidth0Depth2(gainWidthValue0);
+	m->fillmeGainWidth1Depth2(gainWidthValue1);
+	m->fillmeGainWidth2Depth2(gainWidthValue2);
+	m->fillmeGainWidth3Depth2(gainWidthValue3);
 
-	monitor()->fillmePed0Depth2(pedValue0);
-	monitor()->fillmePed1Depth2(pedValue1);
-	monitor()->fillmePed2Depth2(pedValue2);
-	monitor()->fillmePed3Depth2(pedValue3);
+	m->fillmePed0Depth2(pedValue0);
+	m->fillmePed1Depth2(pedValue1);
+	m->fillmePed2Depth2(pedValue2);
+	m->fillmePed3Depth2(pedValue3);
 
-        monitor()->fillmePedWidth0Depth2(pedWidth0);
-        monitor()->fillmePedWidth1Depth2(pedWidth1);
-        monitor()->fillmePedWidth2Depth2(pedWidth2);
-        monitor()->fillmePedWidth3Depth2(pedWidth3);
+      m->fillmePedWidth0Depth2(pedWidth0);
+      m->fillmePedWidth1Depth2(pedWidth1);
+      m->fillmePedWidth2Depth2(pedWidth2);
+      m->fillmePedWidth3Depth2(pedWidth3);
 
-	monitor()->fillmeGainMap2  (double(ieta), double(iphi), gainValue0);
-	monitor()->fillmePwidthMap2(double(ieta), double(iphi), pedWidth0) ;  
-      }
+	m->fillmeGainMap2  (double(ieta), double(iphi), gainValue0);
+	m->fillmePwidthMap2(double(ieta), double(iphi), pedWidth0) ;  
+    }
 
-      if (depth == 3) {
+    if (depth == 3) {
 
 	//        std::cout <<  "          depth = " << depth << std::endl;
 
-	monitor()->fillmeGain0Depth3(gainValue0);
-	monitor()->fillmeGain1Depth3(gainValue1);
-	monitor()->fillmeGain2Depth3(gainValue2);
-	monitor()->fillmeGain3Depth3(gainValue3);
+	m->fillmeGain0Depth3(gainValue0);
+	m->fillmeGain1Depth3(gainValue1);
+	m->fillmeGain2Depth3(gainValue2);
+	m->fillmeGain3Depth3(gainValue3);
 
-	monitor()->fillmeGainWidth0Depth3(gainWidthValue0);
-	monitor()->fillmeGainWidth1Depth3(gainWidthValue1);
-	monitor()->fillmeGainWidth2Depth3(gainWidthValue2);
-	monitor()->fillmeGainWidth3Depth3(gainWidthValue3);
+	m->fillmeGainWidth0Depth3(gainWidthValue0);
+	m->fillmeGainWidth1Depth3(gainWidthValue1);
+	m->fillmeGainWidth2Depth3(gainWidthValue2);
+	m->fillmeGainWidth3Depth3(gainWidthValue3);
 
-	monitor()->fillmePed0Depth3(pedValue0);
-	monitor()->fillmePed1Depth3(pedValue1);
-	monitor()->fillmePed2Depth3(pedValue2);
-	monitor()->fillmePed3Depth3(pedValue3);
+	m->fillmePed0Depth3(pedValue0);
+	m->fillmePed1Depth3(pedValue1);
+	m->fillmePed2Depth3(pedValue2);
+	m->fillmePed3Depth3(pedValue3);
 
-        monitor()->fillmePedWidth0Depth3(pedWidth0);
-        monitor()->fillmePedWidth1Depth3(pedWidth1);
-        monitor()->fillmePedWidth2Depth3(pedWidth2);
-        monitor()->fillmePedWidth3Depth3(pedWidth3);
+      m->fillmePedWidth0Depth3(pedWidth0);
+      m->fillmePedWidth1Depth3(pedWidth1);
+      m->fillmePedWidth2Depth3(pedWidth2);
+      m->fillmePedWidth3Depth3(pedWidth3);
 
-	monitor()->fillmeGainMap3  (double(ieta), double(iphi), gainValue0);
-	monitor()->fillmePwidthMap3(double(ieta), double(iphi), pedWidth0) ;  
-      }
+	m->fillmeGainMap3  (double(ieta), double(iphi), gainValue0);
+	m->fillmePwidthMap3(double(ieta), double(iphi), pedWidth0) ;  
+    }
 
-      if (depth == 4) {
+    if (depth == 4) {
 
 	//        std::cout <<  "          depth = " << depth << std::endl;
 
-	monitor()->fillmeGain0Depth4(gainValue0);
-	monitor()->fillmeGain1Depth4(gainValue1);
-	monitor()->fillmeGain2Depth4(gainValue2);
-	monitor()->fillmeGain3Depth4(gainValue3);
-
-	monitor()->fillmeGainWidth0Depth4(gainWidthValue0);
-	monitor()->fillmeGainWidth1Depth4(gainWidthValue1);
-	monitor()->fillmeGainWidth2Depth4(gainWidthValue2);
-	monitor()->fillmeGainWidth3Depth4(gainWidthValue3);
+	m->fillmeGain0Depth4(gainValue0);
+	m->fillmeGain1Depth4(gainValue1);
+	m->fillmeGain2Depth4(gainValue2);
+	m->fillmeGain3Depth4(gainValue3);
 
-	monitor()->fillmePed0Depth4(pedValue0);
-	monitor()->fillmePed1Depth4(pedValue1);
-	monitor()->fillmePed2Depth4(pedValue2);
-	monitor()->fillmePed3Depth4(pedValue3);
+	m->fillmeGainWidth0Depth4(gainWidthValue0);
+	m->fillmeGainWidth1Depth4(gainWidthValue1);
+	m->fillmeGainWidth2Depth4(gainWidthValue2);
+	m->fillmeGainWidth3Depth4(gainWidthValue3);
 
-        monitor()->fillmePedWidth0Depth4(pedWidth0);
-        monitor()->fillmePedWidth1Depth4(pedWidth1);
-        monitor()->fillmePedWidth2Depth4(pedWidth2);
-        monitor()->fillmePedWidth3Depth4(pedWidth3);
+	m->fillmePed0Depth4(pedValue0);
+	m->fillmePed1Depth4(pedValue1);
+	m->fillmePed2Depth4(pedValue2);
+	m->fillmePed3Depth4(pedValue3);
 
-	monitor()->fillmeGainMap4  (double(ieta), double(iphi), gainValue0);
-	monitor()->fillmePwidthMap4(double(ieta), double(iphi), pedWidth0) ;  
-
-      }
+      m->fillmePedWidth0Depth4(pedWidth0);
+      m->fillmePedWidth1Depth4(pedWidth1);
+      m->fillmePedWidth2Depth4(pedWidth2);
+      m->fillmePedWidth3Depth4(pedWidth3);
 
-    }     // end of event #1 
-    //std::cout << "==== End of event noise block in cell cycle"  << std::endl;
+	m->fillmeGainMap4  (double(ieta), double(iphi), gainValue0);
+	m->fillmePwidthMap4(double(ieta), double(iphi), pedWidth0) ;  
 
+    }
 
+  }     // end of event #1 
+  //std::cout << "==== End of event noise block in cell cycle"  << std::endl;
 
-    if ( sub == subdet)  Ndig++;  // subdet number of digi
+  sd.Ndig++;  // subdet number of digi
     
 // No-noise case, only single  subdet selected  ===========================
 
-    if ( sub == subdet && noise_ == 0 ) {   
+  if ( noise_ == 0 ) {   
 
+    // ADC2fC 
+    const ChannelCalib & calibrations = calib(cell);
+    int nsamples = digi.size();
+    tool_.resize(nsamples);
+    for (int ii=0;ii<nsamples;ii++)
+      tool_[ii] = calibrations.fC[digi[ii].capid()][digi[ii].adc()];
+      
+    double noiseADC =  digi[0].adc();     
+    double noisefC  =  tool_[0];     
       
-      HcalCalibrations calibrations = conditions->getHcalCalibrations(cell);
+    // noise evaluations from "pre-samples"
+    if(depth == 1) { 
+      m->fillmeADC0_depth1  (noiseADC);
+      m->fillmeADC0fC_depth1(noisefC);
+    }
+    if(depth == 2) { 
+      m->fillmeADC0_depth2  (noiseADC);
+      m->fillmeADC0fC_depth2(noisefC);
+    }
+    if(depth == 3) { 
+      m->fillmeADC0_depth3  (noiseADC);
+      m->fillmeADC0fC_depth3(noisefC);
+    }
+    if(depth == 4) { 
+      m->fillmeADC0_depth4  (noiseADC);
+      m->fillmeADC0fC_depth4(noisefC);
+    }
 
-      const HcalQIECoder* channelCoder = conditions->getHcalCoder(cell);
-      const HcalQIEShape* shape = conditions->getHcalShape(channelCoder);
-      HcalCoderDb coder (*channelCoder, *shape);
-      coder.adc2fC(*digiItr,tool);
+    // OCCUPANCY maps filling
+    double deta = double(ieta);
+    double dphi = double(iphi);
+    if(depth == 1)
+      m->fillmeOccupancy_map_depth1(deta, dphi); 
+    if(depth == 2)
+      m->fillmeOccupancy_map_depth2(deta, dphi); 
+    if(depth == 3)
+      m->fillmeOccupancy_map_depth3(deta, dphi); 
+    if(depth == 4)
+      m->fillmeOccupancy_map_depth4(deta, dphi); 
       
-      double noiseADC =  (*digiItr)[0].adc();     
-      double noisefC  =  tool[0];     
+    // Cycle on time slices
+    // - for each Digi 
+    // - for one Digi with max SimHits E in subdet
       
-      // noise evaluations from "pre-samples"
-      if(depth == 1) { 
-	monitor()->fillmeADC0_depth1  (noiseADC);
-	monitor()->fillmeADC0fC_depth1(noisefC);
-      }
-      if(depth == 2) { 
-	monitor()->fillmeADC0_depth2  (noiseADC);
-	monitor()->fillmeADC0fC_depth2(noisefC);
+    int closen = 0;   // =1 if 1) seedSimHit = 1 and 2) the cell is the same
+    if(ieta == sd.ieta_Sim && iphi == sd.iphi_Sim ) closen = sd.seedSimHit;
+
+    for  (int ii=0;ii<nsamples;ii++) {
+      int capid  = digi[ii].capid();
+      // single ts amplitude
+      double val = (tool_[ii]-calibrations.pedestal[capid]);
+
+      if (val > 10.) {
+	if (depth == 1) 
+	  m->fillmeAll10slices_depth1(double(ii), val);
+	else 
+	  m->fillmeAll10slices_depth2(double(ii), val);
       }
-      if(depth == 3) { 
-	monitor()->fillmeADC0_depth3  (noiseADC);
-	monitor()->fillmeADC0fC_depth3(noisefC);
+      if (val > 100.) {
+	if (depth == 1) 
+	  m->fillmeAll10slices1D_depth1(double(ii), val);
+	else 
+	  m->fillmeAll10slices1D_depth2(double(ii), val);
       }
-      if(depth == 4) { 
-	monitor()->fillmeADC0_depth4  (noiseADC);
-	monitor()->fillmeADC0fC_depth4(noisefC);
-      }
-
-      // OCCUPANCY maps filling
-      double deta = double(ieta);
-      double dphi = double(iphi);
-      if(depth == 1)
-      monitor()->fillmeOccupancy_map_depth1(deta, dphi); 
-      if(depth == 2)
-      monitor()->fillmeOccupancy_map_depth2(deta, dphi); 
-      if(depth == 3)
-      monitor()->fillmeOccupancy_map_depth3(deta, dphi); 
-      if(depth == 4)
-      monitor()->fillmeOccupancy_map_depth4(deta, dphi); 
-      
-      // Cycle on time slices
-      // - for each Digi 
-      // - for one Digi with max SimHits E in subdet
-      
-      int closen = 0;   // =1 if 1) seedSimHit = 1 and 2) the cell is the same
-      if(ieta == ieta_Sim && iphi == iphi_Sim ) closen = seedSimHit;
-
-      for  (int ii=0;ii<tool.size();ii++) {
-	int capid  = (*digiItr)[ii].capid();
-        // single ts amplitude
-	double val = (tool[ii]-calibrations.pedestal(capid));
-
-	if (val > 10.) {
-	  if (depth == 1) 
-	    monitor()->fillmeAll10slices_depth1(double(ii), val);
-          else 
-	    monitor()->fillmeAll10slices_depth2(double(ii), val);
-	}
-	if (val > 100.) {
-	  if (depth == 1) 
-	    monitor()->fillmeAll10slices1D_depth1(double(ii), val);
-          else 
-	    monitor()->fillmeAll10slices1D_depth2(double(ii), val);
-	}
  	
-	if( closen == 1 &&( ieta * zsign >= 0 )) { 
-	  monitor()->fillmeSignalTimeSlice(double(ii), val);
-	}
-
+      if( closen == 1 &&( ieta * zsign_ >= 0 )) { 
+	m->fillmeSignalTimeSlice(double(ii), val);
+      }
 
-	// HB/HE/HO
-	if (subdet != 4 && ii>=4 && ii<=7) { 
-	  ampl += val;	  
-	  if(depth == 1) ampl1 += val;   
-	  if(depth == 2) ampl2 += val;   
-	  if(depth == 3) ampl3 += val;   
-	  if(depth == 4) ampl4 += val;
+      // HB/HE/HO: time slices 4-7, HF: time slice 3
+      if ((sub != 4 && ii>=4 && ii<=7) || (sub == 4 && ii==3)) { 
+	ampl += val;	  
+	if(depth == 1) ampl1 += val;   
+	if(depth == 2) ampl2 += val;   
+	if(depth == 3) ampl3 += val;   
+	if(depth == 4) ampl4 += val;
 	  
-	  if( closen == 1 && ( ieta * zsign >= 0 )) { 
-            ampl_c += val;	  
-	    if(depth == 1) ampl1_c += val;   
-	    if(depth == 2) ampl2_c += val;   
-	    if(depth == 3) ampl3_c += val;   
-	    if(depth == 4) ampl4_c += val;
-	    
-	  }
-	}
-	
-	// HF
-	if (subdet == 4 && ii==3 )	{
-	  ampl += val;	    
-	  if(depth == 1)  ampl1 += val;
-	  if(depth == 2)  ampl2 += val;
-	  if(depth == 3)  ampl3 += val;
-	  if(depth == 4)  ampl4 += val;
-	  if( closen == 1 && ( ieta * zsign >= 0 )) { 	    
-	    ampl_c += val;	    
-	    if(depth == 1)  ampl1_c += val;
-	    if(depth == 2)  ampl2_c += val;
-	    if(depth == 3)  ampl3_c += val;
-	    if(depth == 4)  ampl4_c += val;
-
-	  }
+	if( closen == 1 && ( ieta * zsign_ >= 0 )) { 
+	  sd.ampl_c[0] += val;	  
+	  if(depth >= 1 && depth <= 4) sd.ampl_c[depth] += val;   
 	}
       }
-      // end of time bucket sample      
+    }
+    // end of time bucket sample      
       
-      monitor()->fillmeAmplIetaIphi1(double(ieta),double(iphi), ampl1);
-      monitor()->fillmeAmplIetaIphi2(double(ieta),double(iphi), ampl2);
-      monitor()->fillmeAmplIetaIphi3(double(ieta),double(iphi), ampl3);
-      monitor()->fillmeAmplIetaIphi4(double(ieta),double(iphi), ampl4);
-      monitor()->fillmeSumAmp (ampl);
+    m->fillmeAmplIetaIphi1(double(ieta),double(iphi), ampl1);
+    m->fillmeAmplIetaIphi2(double(ieta),double(iphi), ampl2);
+    m->fillmeAmplIetaIphi3(double(ieta),double(iphi), ampl3);
+    m->fillmeAmplIetaIphi4(double(ieta),double(iphi), ampl4);
+    m->fillmeSumAmp (ampl);
       
       
-      if(ampl1 > 10. || ampl2 > 10.  || ampl3 > 10.  || ampl4 > 10. ) ndigis++;
+    if(ampl1 > 10. || ampl2 > 10.  || ampl3 > 10.  || ampl4 > 10. ) sd.ndigis++;
       
-      // fraction 5,6 bins if ampl. is big.
-      if(ampl1 > 30. &&  depth == 1 && closen == 1 ) { 
-	  double fBin5  = tool[4] - calibrations.pedestal((*digiItr)[4].capid());
-	double fBin67 = tool[5] + tool[6] 
-	  - calibrations.pedestal((*digiItr)[5].capid())
-	  - calibrations.pedestal((*digiItr)[6].capid());
-	fBin5  /= ampl1;
-	fBin67 /= ampl1;
-	monitor()->fillmeBin5Frac (fBin5);
-	monitor()->fillmeBin67Frac(fBin67);
-      }
+    // fraction 5,6 bins if ampl. is big.
+    if(ampl1 > 30. &&  depth == 1 && closen == 1 ) { 
+      double fBin5  = tool_[4] - calibrations.pedestal[digi[4].capid()];
+      double fBin67 = tool_[5] + tool_[6] 
+	- calibrations.pedestal[digi[5].capid()]
+	- calibrations.pedestal[digi[6].capid()];
+      fBin5  /= ampl1;
+      fBin67 /= ampl1;
+      m->fillmeBin5Frac (fBin5);
+      m->fillmeBin67Frac(fBin67);
+    }
 
-      monitor()->fillmeSignalAmp (ampl); 
-      monitor()->fillmeSignalAmp1(ampl1); 
-      monitor()->fillmeSignalAmp2(ampl2); 
-      monitor()->fillmeSignalAmp3(ampl3); 
-      monitor()->fillmeSignalAmp4(ampl4); 
-    
-      
-    }   
-  }    // End of CYCLE OVER CELLS =============================================
-  
-  
-  if ( subdet != 0 && noise_ == 0) { // signal only, once per event 
+    m->fillmeSignalAmp (ampl); 
+    m->fillmeSignalAmp1(ampl1); 
+    m->fillmeSignalAmp2(ampl2); 
+    m->fillmeSignalAmp3(ampl3); 
+    m->fillmeSignalAmp4(ampl4); 
+  }   
+} // end recoDigi method
+
+void HcalDigiTester::endEvent(Subdet & sd) {
 
-    monitor()->fillmenDigis(ndigis);
+  // signal only, once per event 
+  HcalSubdetDigiMonitor * m = sd.monitor;
+  m->fillmenDigis(sd.ndigis);
     
-    // SimHits once again !!!
+  if(mc_ == "yes") {
     double eps    = 1.e-3;
-    double ehits  = 0.; 
-    double ehits1 = 0.; 
-    double ehits2 = 0.; 
-    double ehits3 = 0.; 
-    double ehits4 = 0.; 
- 
-    if(mc_ == "yes") {
-      edm::Handle<edm::PCaloHitContainer> hcalHits ;
-      iEvent.getByToken(tok_mc_,hcalHits); 
-      const edm::PCaloHitContainer * simhitResult = hcalHits.product () ;
-      for (std::vector<PCaloHit>::const_iterator simhits = simhitResult->begin ();         simhits != simhitResult->end () ;  ++simhits) {
-	
-	HcalDetId cell(simhits->id());
-	int ieta   = cell.ieta();
-	if(ieta > 0) ieta--;
-	int iphi   = cell.iphi()-1; 
-	int sub    = cell.subdet();
-	
-	// take cell already found to be max energy in a particular subdet
-	if (sub == subdet && ieta == ieta_Sim && iphi == iphi_Sim){  
-	  int depth = cell.depth();
-	  double en = simhits->energy();
-	  
-	  ehits += en;
-	  if(depth == 1)  ehits1 += en; 
-	  if(depth == 2)  ehits2 += en; 
-	  if(depth == 3)  ehits3 += en; 
-	  if(depth == 4)  ehits4 += en; 
-	}
-      }
-      
-      if(ehits  > eps) monitor()->fillmeDigiSimhit (ehits,  ampl_c );
-      if(ehits1 > eps) monitor()->fillmeDigiSimhit1(ehits1, ampl1_c);
-      if(ehits2 > eps) monitor()->fillmeDigiSimhit2(ehits2, ampl2_c);
-      if(ehits3 > eps) monitor()->fillmeDigiSimhit3(ehits3, ampl3_c);
-      if(ehits4 > eps) monitor()->fillmeDigiSimhit4(ehits4, ampl4_c);
+    const double * ehits  = sd.ehits;
+    const double * ampl_c = sd.ampl_c;
+
+    if(ehits[0] > eps) m->fillmeDigiSimhit (ehits[0], ampl_c[0]);
+    if(ehits[1] > eps) m->fillmeDigiSimhit1(ehits[1], ampl_c[1]);
+    if(ehits[2] > eps) m->fillmeDigiSimhit2(ehits[2], ampl_c[2]);
+    if(ehits[3] > eps) m->fillmeDigiSimhit3(ehits[3], ampl_c[3]);
+    if(ehits[4] > eps) m->fillmeDigiSimhit4(ehits[4], ampl_c[4]);
       
-      if(ehits  > eps) monitor()->fillmeDigiSimhitProfile (ehits,  ampl_c );
-      if(ehits1 > eps) monitor()->fillmeDigiSimhitProfile1(ehits1, ampl1_c);
-      if(ehits2 > eps) monitor()->fillmeDigiSimhitProfile2(ehits2, ampl2_c);
-      if(ehits3 > eps) monitor()->fillmeDigiSimhitProfile3(ehits3, ampl3_c);
-      if(ehits4 > eps) monitor()->fillmeDigiSimhitProfile4(ehits4, ampl4_c);
+    if(ehits[0] > eps) m->fillmeDigiSimhitProfile (ehits[0], ampl_c[0]);
+    if(ehits[1] > eps) m->fillmeDigiSimhitProfile1(ehits[1], ampl_c[1]);
+    if(ehits[2] > eps) m->fillmeDigiSimhitProfile2(ehits[2], ampl_c[2]);
+    if(ehits[3] > eps) m->fillmeDigiSimhitProfile3(ehits[3], ampl_c[3]);
+    if(ehits[4] > eps) m->fillmeDigiSimhitProfile4(ehits[4], ampl_c[4]);
       
-      if(ehits  > eps) monitor()->fillmeRatioDigiSimhit (ampl_c  / ehits);
-      if(ehits1 > eps) monitor()->fillmeRatioDigiSimhit1(ampl1_c / ehits1);
-      if(ehits2 > eps) monitor()->fillmeRatioDigiSimhit2(ampl2_c / ehits2);
-      if(ehits3 > eps) monitor()->fillmeRatioDigiSimhit3(ampl3_c / ehits3);
-      if(ehits4 > eps) monitor()->fillmeRatioDigiSimhit4(ampl4_c / ehits4);
-    } // end of if(mc_ == "yes")
+    if(ehits[0] > eps) m->fillmeRatioDigiSimhit (ampl_c[0] / ehits[0]);
+    if(ehits[1] > eps) m->fillmeRatioDigiSimhit1(ampl_c[1] / ehits[1]);
+    if(ehits[2] > eps) m->fillmeRatioDigiSimhit2(ampl_c[2] / ehits[2]);
+    if(ehits[3] > eps) m->fillmeRatioDigiSimhit3(ampl_c[3] / ehits[3]);
+    if(ehits[4] > eps) m->fillmeRatioDigiSimhit4(ampl_c[4] / ehits[4]);
+  } // end of if(mc_ == "yes")
    
-    monitor()->fillmeNdigis(double(Ndig));
-    
-  } //  end of if( subdet != 0 && noise_ == 0)  // signal only 
-
-} // end reco method
+  m->fillmeNdigis(double(sd.Ndig));
+}
 
 
 HcalDigiTester::HcalDigiTester(const edm::ParameterSet& iConfig):
@@ -534,13 +501,19 @@ HcalDigiTester::HcalDigiTester(const edm::ParameterSet& iConfig):
   tok_ho_ = consumes<edm::SortedCollection<HODataFrame> >(edm::InputTag(inputTag_));
   tok_hf_ = consumes<edm::SortedCollection<HFDataFrame> >(edm::InputTag(inputTag_));
 
-  nevent1 = 0;
-  nevent2 = 0;
-  nevent3 = 0;
-  nevent4 = 0;
-
   nevtot  = 0;
 
+  zsign_ = 0;
+  if (zside_ == "+")  zsign_ =  1;
+  if (zside_ == "-")  zsign_ = -1;
+
+  for (int sub = 0; sub <= 4; sub++) {
+    subdets_[sub].monitor = 0;
+    subdets_[sub].nevent  = 0;
+  }
+
+  calibCacheId_ = 0;
+
   if ( outputFile_.size() != 0 ) {
     edm::LogInfo("OutputInfo") << " Hcal Digi Task histograms will be saved to '" << outputFile_.c_str() << "'";
   } else {
@@ -603,6 +576,17 @@ void HcalDigiTester::bookHistograms(DQMStore::IBooker &ibooker, edm::Run const &
     hcalselector_ = "all";    
   }
 
+  // monitors of the selected subdetectors, looked up once
+  const char * names[5] = {"", "HB", "HE", "HO", "HF"};
+  bool all = (hcalselector_ == "all" || hcalselector_ == "noise");
+  for (int sub = 1; sub <= 4; sub++) {
+    subdets_[sub].monitor = 0;
+    if (all || hcalselector_ == names[sub]) {
+      std::map<std::string, HcalSubdetDigiMonitor*>::iterator monitorItr
+	= monitors_.find(names[sub]);
+      if (monitorItr != monitors_.end()) subdets_[sub].monitor = monitorItr->second;
+    }
+  }
 }
 
 
@@ -736,51 +720,47 @@ HcalDigiTester::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   iSetup.get<CaloGeometryRecord>().get (geometry);
   iSetup.get<HcalDbRecord>().get(conditions);
 
+  // the ADC->fC tables are valid as long as the conditions are
+  unsigned long long cacheId = iSetup.get<HcalDbRecord>().cacheIdentifier();
+  if (cacheId != calibCacheId_) {
+    calibCacheId_ = cacheId;
+    calibIndex_.assign(kCalibChannels, -1);
+    calibs_.clear();
+  }
 
   //  std::cout << " >>>>> HcalDigiTester::analyze  hcalselector = " 
   //	    << hcalselector_ << std::endl;
 
-  if( hcalselector_ != "all") {
-    noise_ = 0;
-    
-    
-
-    if (hcalselector_ == "HB" ) reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-    if (hcalselector_ == "HE" ) reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-    if (hcalselector_ == "HO" ) reco<HODataFrame>(iEvent,iSetup,tok_ho_);
-    if (hcalselector_ == "HF" ) reco<HFDataFrame>(iEvent,iSetup,tok_hf_);  
+  // "noise": gains and pedestals of all the subdetectors;
+  // "all" or a single subdetector: signal
+  noise_ = (hcalselector_ == "noise") ? 1 : 0;
+
+  for (int sub = 1; sub <= 4; sub++) {
+    Subdet & sd = subdets_[sub];
+    if (sd.monitor == 0) continue;
+    sd.nevent++;
+    sd.seedSimHit = 0;
+    sd.seedDone   = false;
+    sd.ieta_Sim   =  9999;
+    sd.iphi_Sim   =  9999;
+    sd.emax_Sim   = -9999.;
+    sd.ndigis     = 0;
+    sd.Ndig       = 0;
+    for (int k = 0; k < 5; k++) sd.ampl_c[k] = sd.ehits[k] = 0.;
+  }
 
-    if (hcalselector_ == "noise") {
-      noise_ = 1;
+  // SimHits MC only, signal only
+  if (mc_ == "yes" && noise_ == 0) scanSimHits(iEvent);
 
-      //      std::cout << " >>>>> HcalDigiTester::analyze  entering noise " 
-      //	    << std::endl;
+  // HB and HE share the collection
+  if (subdets_[1].monitor != 0 || subdets_[2].monitor != 0)
+    reco<HBHEDataFrame>(iEvent,tok_hbhe_);
+  if (subdets_[3].monitor != 0) reco<HODataFrame>(iEvent,tok_ho_);
+  if (subdets_[4].monitor != 0) reco<HFDataFrame>(iEvent,tok_hf_);
 
-      
-      hcalselector_ = "HB";
-      reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-      hcalselector_ = "HE";
-      reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-      hcalselector_ = "HO";
-      reco<HODataFrame>(iEvent,iSetup,tok_ho_);
-      hcalselector_ = "HF";
-      reco<HFDataFrame>(iEvent,iSetup,tok_hf_);
-      hcalselector_ = "noise";
-    }
-  }    
-    // all subdetectors
-  else {
-    noise_ = 0;
-    
-    hcalselector_ = "HB";
-    reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-    hcalselector_ = "HE";
-    reco<HBHEDataFrame>(iEvent,iSetup,tok_hbhe_);
-    hcalselector_ = "HO";
-    reco<HODataFrame>(iEvent,iSetup,tok_ho_);
-    hcalselector_ = "HF";
-    reco<HFDataFrame>(iEvent,iSetup,tok_hf_);
-    hcalselector_ = "all";    
+  if (noise_ == 0) {
+    for (int sub = 1; sub <= 4; sub++)
+      if (subdets_[sub].monitor != 0) endEvent(subdets_[sub]);
   }
 
   nevtot++;
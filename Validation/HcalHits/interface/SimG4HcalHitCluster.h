@@ -1,11 +1,15 @@
 ///////////////////////////////////////////////////////////////////////////////
 // File: SimG4HcalHitCluster.h
 // Cluster class for analysis in SimG4HcalValidation
+// The hits are summed as massless four-vectors (px, py, pz, E); eta and
+// phi are derived from the sums when asked for. The hits are kept as
+// indices into the input of SimG4HcalHitJetFinder.
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef Validation_HcalHits_SimG4HcalHitCluster_H
 #define Validation_HcalHits_SimG4HcalHitCluster_H
 
 #include "SimDataFormats/CaloHit/interface/CaloHit.h"
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -17,22 +21,27 @@ public:
   virtual ~SimG4HcalHitCluster();
 
   double e()   const {return ec;}
-  double eta() const {return etac;}
-  double phi() const {return phic;}
-  std::vector<CaloHit> * getHits() {return &hitsc;}
+  double eta() const {if (!valid) direction(); return etac;}
+  double phi() const {if (!valid) direction(); return phic;}
+  const std::vector<unsigned int> & getHits() const {return hitsc;}
 
   bool operator<(const SimG4HcalHitCluster& cluster) const; 
-  SimG4HcalHitCluster& operator+=(const CaloHit& hit);
+  // adds the hit, index is its position in the jet finder input
+  SimG4HcalHitCluster& add(const CaloHit& hit, unsigned int index);
 
-  double collectEcalEnergyR(); 
+  double collectEcalEnergyR() const {return eecal;}
 
 private:
 
   double my_cosh(float eta) {return 0.5 * (exp(eta) + exp(-eta));}
   double my_sinh(float eta) {return 0.5 * (exp(eta) - exp(-eta));}
 
-  double ec, etac, phic;
-  std::vector<CaloHit> hitsc;
+  void   direction() const;
+
+  double                    ec, pxc, pyc, pzc, eecal;
+  mutable double            etac, phic;
+  mutable bool              valid;
+  std::vector<unsigned int> hitsc;
 
 };
 
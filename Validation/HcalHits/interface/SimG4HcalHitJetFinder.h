@@ -20,6 +20,9 @@ public:
   void setCone(double);   
   void setInput(std::vector<CaloHit> *);
   std::vector<SimG4HcalHitCluster> * getClusters(bool);
+  // input hit of a cluster (SimG4HcalHitCluster::getHits), valid until
+  // the next setInput
+  const CaloHit & getHit(unsigned int index) const {return input[index];}
   double rDist(const SimG4HcalHitCluster* , const CaloHit*) const;
   double rDist(const double, const double, const double, const double) const;
 
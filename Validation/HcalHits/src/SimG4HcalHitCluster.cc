@@ -4,67 +4,50 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "Validation/HcalHits/interface/SimG4HcalHitCluster.h"
 
-#include "CLHEP/Vector/LorentzVector.h"
-
-SimG4HcalHitCluster::SimG4HcalHitCluster(): ec(0), etac(0), phic(0) {}
+SimG4HcalHitCluster::SimG4HcalHitCluster(): ec(0), pxc(0), pyc(0), pzc(0),
+					    eecal(0), etac(0), phic(0),
+					    valid(true) {}
 
 SimG4HcalHitCluster::~SimG4HcalHitCluster() {}
 
 bool SimG4HcalHitCluster::operator<(const SimG4HcalHitCluster& cluster) const {
-  return (ec/cosh(etac) < cluster.e()/cosh(cluster.eta())) ? false : true ;
+  return (ec/cosh(eta()) < cluster.e()/cosh(cluster.eta())) ? false : true ;
 }
 
-SimG4HcalHitCluster& SimG4HcalHitCluster::operator+=(const CaloHit& hit) {
-
-  hitsc.push_back(hit);
- 
-  if (ec == 0. && etac == 0. && phic == 0.) {
-    ec   = hit.e();
-    etac = hit.eta();
-    phic = hit.phi();
-  } else {   
-    // cluster px,py,pz
-    double et = ec / my_cosh(etac);
-    double px = et * cos(phic);
-    double py = et * sin(phic);
-    double pz = et * my_sinh(etac); 
-
-    CLHEP::HepLorentzVector clusHLV(px,py,pz,ec);
-      
-    // hit px,py,pz
-    double eh   = hit.e();
-    double etah = hit.eta();
-    double phih = hit.phi();
-    et = eh / my_cosh(etah);
-    px = et * cos(phih);
-    py = et * sin(phih);
-    pz = et * my_sinh(etah); 
-      
-    CLHEP::HepLorentzVector hitHLV(px,py,pz,eh);
-      
-    // clus + hit
-    clusHLV += hitHLV;
-      
-    double theta  = clusHLV.theta();
-    etac = -log(tan(theta/2.));
-    phic = clusHLV.phi();
-    ec   = clusHLV.t();
+SimG4HcalHitCluster& SimG4HcalHitCluster::add(const CaloHit& hit, 
+					      unsigned int index) {
+
+  // hit px,py,pz
+  double eh   = hit.e();
+  double etah = hit.eta();
+  double phih = hit.phi();
+  double et   = eh / my_cosh(etah);
+  pxc += et * cos(phih);
+  pyc += et * sin(phih);
+  pzc += et * my_sinh(etah); 
+  ec  += eh;
+
+  if (hitsc.empty()) {
+    // a single hit cluster is in the direction of the hit
+    etac  = etah;
+    phic  = phih;
+    valid = true;
+  } else {
+    valid = false;
   }
+  hitsc.push_back(index);
+
+  if (hit.det() == 10 || hit.det() == 11 || hit.det() == 12) eecal += eh;
 
   return *this;
 }
 
-double SimG4HcalHitCluster::collectEcalEnergyR() {
-
-  double sum = 0.;
-  std::vector<CaloHit>::iterator itr;
+void SimG4HcalHitCluster::direction() const {
 
-  for (itr = hitsc.begin(); itr < hitsc.end(); itr++) {
-    if (itr->det() == 10 || itr->det() == 11 || itr->det() == 12) {
-      sum += itr->e(); 
-    }    
-  }
-  return sum;
+  double theta = atan2(sqrt(pxc*pxc + pyc*pyc), pzc);
+  etac  = -log(tan(theta/2.));
+  phic  = (pxc == 0. && pyc == 0.) ? 0. : atan2(pyc, pxc);
+  valid = true;
 }
 
 std::ostream& operator<<(std::ostream& os, const SimG4HcalHitCluster& cluster){
@@ -62,7 +62,7 @@ std::vector<SimG4HcalHitCluster>* SimG4HcalHitJetFinder::getClusters(bool hcal_o
 	  h_type == static_cast<int>(HcalEndcap) ||
 	  h_type == static_cast<int>(HcalForward)) && hcal_only) || 
 	(!hcal_only)) {
-      cluster += input[j];
+      cluster.add(input[j], j);
       LogDebug("ValidHcal") << "HcalHitJetFinder:: First seed hit "
 			    << "..................\n" << (*itr_hits);
       first_seed = j;
@@ -96,7 +96,7 @@ std::vector<SimG4HcalHitCluster>* SimG4HcalHitJetFinder::getClusters(bool hcal_o
 	double d = rDist(&(*itr_clus), &(*itr_hits));
 	if (d < jetcone) {
 	  LogDebug("ValidHcal") << "HcalHitJetFinder:: -> associated ... ";
-	  temp[iclus] += *itr_hits;
+	  temp[iclus].add(*itr_hits, j);
 	  incl = 1;
 	  break;  
 	}
@@ -105,7 +105,7 @@ std::vector<SimG4HcalHitCluster>* SimG4HcalHitJetFinder::getClusters(bool hcal_o
       // to here jumps "break"
       if (incl == 0) {
 	SimG4HcalHitCluster cl;
-	cl += *itr_hits;
+	cl.add(*itr_hits, j);
 	temp.push_back(cl);
 	LogDebug("ValidHcal") << "HcalHitJetFinder:: ************ NEW CLUSTER"
 			      << " !\n" << cl;
@@ -113,7 +113,7 @@ std::vector<SimG4HcalHitCluster>* SimG4HcalHitJetFinder::getClusters(bool hcal_o
     }
   }
 
-  clusvector = temp;
+  clusvector.swap(temp);
   return &clusvector;
 }
 
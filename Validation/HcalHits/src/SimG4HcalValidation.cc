@@ -571,33 +571,33 @@ void SimG4HcalValidation::jetAnalysis(PHcalValidInfoJets& product) {
    
     LogDebug("ValidHcal") << " JetAnalysis ===> after fillEtaPhiProfileJet";
     
-    std::vector<CaloHit> * hits = clus_itr->getHits() ;
-    std::vector<CaloHit>::iterator hit_itr;
+    const std::vector<unsigned int> & hits = clus_itr->getHits() ;
 
     double ee = 0., he = 0., hoe = 0., etot = 0.;
     
     // cycle over all hits in the FIRST cluster
-    for (hit_itr = hits->begin(); hit_itr < hits->end(); hit_itr++) {
-      double e   = hit_itr->e();
-      double t   = hit_itr->t();
-      double r   = jetf->rDist(&(*clus_itr), &(*hit_itr));
+    for (unsigned int k = 0; k < hits.size(); k++) {
+      const CaloHit & hit = jetf->getHit(hits[k]);
+      double e   = hit.e();
+      double t   = hit.t();
+      double r   = jetf->rDist(&(*clus_itr), &hit);
 
       // energy collection
       etot += e;
-      if (hit_itr->det()  == 10 || hit_itr->det()  == 11 ||
-	  hit_itr->det()  == 12) ee  += e;
-      if (hit_itr->det()  == static_cast<int>(HcalBarrel) ||
-	  hit_itr->det()  == static_cast<int>(HcalEndcap) ||
-	  hit_itr->det()  == static_cast<int>(HcalForward)) { 
+      if (hit.det()  == 10 || hit.det()  == 11 ||
+	  hit.det()  == 12) ee  += e;
+      if (hit.det()  == static_cast<int>(HcalBarrel) ||
+	  hit.det()  == static_cast<int>(HcalEndcap) ||
+	  hit.det()  == static_cast<int>(HcalForward)) { 
 	he  += e; 
-	if (hit_itr->det()  == static_cast<int>(HcalBarrel) &&
-	    hit_itr->layer() > 17) 
+	if (hit.det()  == static_cast<int>(HcalBarrel) &&
+	    hit.layer() > 17) 
 	  hoe += e; 
       }
 
-      if (hit_itr->det()  == static_cast<int>(HcalBarrel) ||
-	  hit_itr->det()  == static_cast<int>(HcalEndcap) ||
-	  hit_itr->det()  == static_cast<int>(HcalForward)) { 
+      if (hit.det()  == static_cast<int>(HcalBarrel) ||
+	  hit.det()  == static_cast<int>(HcalEndcap) ||
+	  hit.det()  == static_cast<int>(HcalForward)) { 
 	product.fillTProfileJet(he, r, t);
       }
     }
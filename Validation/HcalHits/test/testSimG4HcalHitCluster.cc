@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: testSimG4HcalHitCluster.cc
+// Description: Four-vector sums, direction and ECAL energy of
+//              SimG4HcalHitCluster
+///////////////////////////////////////////////////////////////////////////////
+#include <cppunit/extensions/HelperMacros.h>
+#include "Validation/HcalHits/interface/SimG4HcalHitCluster.h"
+// the cluster is built into the plugin, which a test cannot link
+#include "Validation/HcalHits/src/SimG4HcalHitCluster.cc"
+
+#include <cmath>
+#include <vector>
+
+class testSimG4HcalHitCluster : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(testSimG4HcalHitCluster);
+  CPPUNIT_TEST(checkSingleHit);
+  CPPUNIT_TEST(checkSums);
+  CPPUNIT_TEST(checkEcalAndHits);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkSingleHit();
+  void checkSums();
+  void checkEcalAndHits();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testSimG4HcalHitCluster);
+
+void testSimG4HcalHitCluster::checkSingleHit() {
+
+  // the direction of a single hit is kept as it is (phi not folded)
+  SimG4HcalHitCluster cluster;
+  cluster.add(CaloHit(1, 1, 12.5, -1.7, 5.0, 10.), 3);
+  CPPUNIT_ASSERT_EQUAL(12.5, cluster.e());
+  CPPUNIT_ASSERT_EQUAL(-1.7, cluster.eta());
+  CPPUNIT_ASSERT_EQUAL(5.0, cluster.phi());
+}
+
+void testSimG4HcalHitCluster::checkSums() {
+
+  // the direction is that of the Cartesian sum of the hit momenta
+  const double e[3]   = {10., 4., 2.5};
+  const double eta[3] = {0.3, 0.5, -0.2};
+  const double phi[3] = {1.0, 1.2, 0.7};
+  SimG4HcalHitCluster cluster;
+  double px = 0., py = 0., pz = 0., etot = 0.;
+  for (int k = 0; k < 3; ++k) {
+    cluster.add(CaloHit(1, 1, e[k], eta[k], phi[k], 0.), k);
+    double et = e[k]/std::cosh(eta[k]);
+    px   += et*std::cos(phi[k]);
+    py   += et*std::sin(phi[k]);
+    pz   += et*std::sinh(eta[k]);
+    etot += e[k];
+
+    // the direction follows each addition
+    double theta = std::atan2(std::sqrt(px*px+py*py), pz);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(etot, cluster.e(), 1.e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-std::log(std::tan(theta/2.)), cluster.eta(), 1.e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::atan2(py, px), cluster.phi(), 1.e-6);
+  }
+
+  // Change in output: before the Cartesian sums, each hit was added to a
+  // massless vector of energy ec along the cluster direction. That gives
+  // the same direction for two hits, not for three or more. These are
+  // the values of both methods for the three hits above.
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.27399616, cluster.eta(), 1.e-7);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.99873039, cluster.phi(), 1.e-7);
+  const double etaIterative = 0.27449430, phiIterative = 0.99905656;
+  CPPUNIT_ASSERT(std::fabs(cluster.eta()-etaIterative) > 4.e-4);
+  CPPUNIT_ASSERT(std::fabs(cluster.phi()-phiIterative) > 3.e-4);
+
+  // two equal hits symmetric in eta and phi
+  SimG4HcalHitCluster symmetric;
+  symmetric.add(CaloHit(1, 1, 5., 0.4, 0.1, 0.), 0);
+  symmetric.add(CaloHit(1, 1, 5., -0.4, -0.1, 0.), 1);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0., symmetric.eta(), 1.e-9);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0., symmetric.phi(), 1.e-9);
+
+  // ordered by decreasing transverse energy
+  SimG4HcalHitCluster central, forward;
+  central.add(CaloHit(1, 1, 10., 0., 0., 0.), 0);
+  forward.add(CaloHit(1, 1, 20., 3., 0., 0.), 1);
+  CPPUNIT_ASSERT(central < forward);
+  CPPUNIT_ASSERT(!(forward < central));
+}
+
+void testSimG4HcalHitCluster::checkEcalAndHits() {
+
+  // ECAL hits are det 10, 11 and 12
+  SimG4HcalHitCluster cluster;
+  const int det[5] = {10, 1, 11, 12, 4};
+  for (int k = 0; k < 5; ++k) cluster.add(CaloHit(det[k], 1, k+1., 0.1*k, 0.2, 0.), 7+k);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.+3.+4., cluster.collectEcalEnergyR(), 1.e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(15., cluster.e(), 1.e-12);
+
+  // the hits are the indices given, in order
+  const std::vector<unsigned int> & hits = cluster.getHits();
+  CPPUNIT_ASSERT_EQUAL(5u, (unsigned int)hits.size());
+  for (unsigned int k = 0; k < hits.size(); ++k) CPPUNIT_ASSERT_EQUAL(7+k, hits[k]);
+}